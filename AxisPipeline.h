@@ -0,0 +1,183 @@
+/**
+ * @file AxisPipeline.h
+ *
+ * @brief Compile-time axis processing pipeline shared by the
+ *        joysticks and the mpu-6050 tilt input
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include "Arduino.h"
+#include "Joystick.h"
+#include "Mpu6050.h"
+#include "Fixed.h"
+#include "Tuning.h"
+
+/*
+* Every axis goes through the same steps:
+*
+*   Source       - reads the raw value and knows its full range
+*   Deadzone     - resting band, values at or past its edges are active
+*   Curve        - maps the distance past an edge to a 0-255 magnitude,
+*                  through a per-span scale the pipeline caches
+*   Orientation  - writes the signed result to the output fields
+*
+* Policies are plain structs with static functions, so each
+* AxisPipeline<> instantiation compiles down to straight-line code
+* for that axis, with no runtime branching on configuration.
+*/
+template <class Source, class Deadzone, class Curve, class Orientation>
+struct AxisPipeline {
+    typedef typename Source::wide_type wide_type;
+
+    template <class Input, class Output>
+    static void run(const Input& in, Output& out) {
+        wide_type raw = Source::read(in);
+        wide_type neg_edge = Deadzone::neg_edge();
+        wide_type pos_edge = Deadzone::pos_edge();
+        int16_t val = 0;
+
+        if (raw <= neg_edge) {
+            val = -static_cast<int16_t>(shape(neg_edge - raw, neg_edge - Source::min_raw(), _neg));
+        } else if (raw >= pos_edge) {
+            val = shape(raw - pos_edge, Source::max_raw() - pos_edge, _pos);
+        }
+        Orientation::write(out, val);
+    }
+
+private:
+    // curve scale of each side, only recomputed when its span changes
+    // (calibration or new boundaries), so a sample costs no division
+    struct Side {
+        wide_type span;
+        typename Curve::scale_type scale;
+    };
+    static Side _neg;
+    static Side _pos;
+
+    static uint8_t shape(wide_type offset, wide_type span, Side& side) {
+        if (offset >= span) return 255;
+        if (span != side.span) {
+            side.span = span;
+            side.scale = Curve::scale(span);
+        }
+        return Curve::shape(offset, side.scale);
+    }
+};
+
+template <class Source, class Deadzone, class Curve, class Orientation>
+typename AxisPipeline<Source, Deadzone, Curve, Orientation>::Side
+    AxisPipeline<Source, Deadzone, Curve, Orientation>::_neg = { 0, 0 };
+
+template <class Source, class Deadzone, class Curve, class Orientation>
+typename AxisPipeline<Source, Deadzone, Curve, Orientation>::Side
+    AxisPipeline<Source, Deadzone, Curve, Orientation>::_pos = { 0, 0 };
+
+/********************************* sources *********************************/
+// joystick x axis (vrx pin)
+struct JoystickX {
+    typedef int16_t wide_type;
+    static int16_t read(const Joystick& j) { return analogRead(j.vrx_pin); }
+    static int16_t min_raw() { return 0; }
+    static int16_t max_raw() { return 1023; }
+};
+
+// joystick y axis (vry pin)
+struct JoystickY {
+    typedef int16_t wide_type;
+    static int16_t read(const Joystick& j) { return analogRead(j.vry_pin); }
+    static int16_t min_raw() { return 0; }
+    static int16_t max_raw() { return 1023; }
+};
+
+// mpu-6050 x acceleration, clipped to the configured boundaries
+struct MpuAccX {
+    typedef int32_t wide_type;
+    static int16_t read(const Mpu6050::RawData& raw) { return raw.x_acc; }
+    static int16_t min_raw() { return Mpu6050::lower_boundary(); }
+    static int16_t max_raw() { return Mpu6050::upper_boundary(); }
+};
+
+// mpu-6050 y acceleration, clipped to the configured boundaries
+struct MpuAccY {
+    typedef int32_t wide_type;
+    static int16_t read(const Mpu6050::RawData& raw) { return raw.y_acc; }
+    static int16_t min_raw() { return Mpu6050::lower_boundary(); }
+    static int16_t max_raw() { return Mpu6050::upper_boundary(); }
+};
+
+/******************************** deadzones ********************************/
+// fixed resting band, values in (NegEdge, PosEdge) read as 0
+template <int16_t NegEdge, int16_t PosEdge>
+struct CenterDeadzone {
+    static int16_t neg_edge() { return NegEdge; }
+    static int16_t pos_edge() { return PosEdge; }
+};
+
+// resting band around Center, as wide as the tuning deadzone
+template <int16_t Center>
+struct TunedDeadzone {
+    static int16_t neg_edge() { return Center - Tuning::deadzone(); }
+    static int16_t pos_edge() { return Center + Tuning::deadzone(); }
+};
+
+// oscillating range measured by calibrate_mpu_6050
+struct CalibratedDeadzoneX {
+    static int16_t neg_edge() { return Mpu6050::min_x_acc(); }
+    static int16_t pos_edge() { return Mpu6050::max_x_acc(); }
+};
+
+struct CalibratedDeadzoneY {
+    static int16_t neg_edge() { return Mpu6050::min_y_acc(); }
+    static int16_t pos_edge() { return Mpu6050::max_y_acc(); }
+};
+
+/********************************* curves **********************************/
+// map(offset, 0, span, 0, 255) as a multiply by the Q16 reciprocal
+// of the span, at most one count above the exact division
+struct LinearCurve {
+    typedef uint32_t scale_type;
+
+    static uint32_t scale(uint32_t span) {
+        return Fixed::reciprocal(255, span, 16);
+    }
+    static uint8_t shape(uint32_t offset, uint32_t scale) {
+        return Fixed::saturate<uint8_t>((offset * scale) >> 16);
+    }
+};
+
+/****************************** orientations *******************************/
+// negative values go to left, positive values go to right
+struct LeftRight {
+    static void write(Joystick& j, int16_t val) {
+        j.left = (val < 0) ? -val : 0;
+        j.right = (val > 0) ? val : 0;
+    }
+    static void write(Mpu6050::Instance& mpu, int16_t val) {
+        mpu.left((val < 0) ? -val : 0);
+        mpu.right((val > 0) ? val : 0);
+    }
+};
+
+// negative values go to up, positive values go to down
+struct UpDown {
+    static void write(Joystick& j, int16_t val) {
+        j.up = (val < 0) ? -val : 0;
+        j.down = (val > 0) ? val : 0;
+    }
+};
+
+// negative values go to down, positive values go to up
+struct DownUp {
+    static void write(Joystick& j, int16_t val) {
+        j.down = (val < 0) ? -val : 0;
+        j.up = (val > 0) ? val : 0;
+    }
+    static void write(Mpu6050::Instance& mpu, int16_t val) {
+        mpu.down((val < 0) ? -val : 0);
+        mpu.up((val > 0) ? val : 0);
+    }
+};
@@ -0,0 +1,110 @@
+/**
+ * @file Board.h
+ *
+ * @brief Compile-time board description, every signal is a Pin<>
+ *        type that reads and writes its port register directly
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <avr/io.h>
+
+namespace Board {
+    // atmega328 ports, PINx/DDRx/PORTx are three io registers apart
+    const uint8_t port_b = 0;
+    const uint8_t port_c = 1;
+    const uint8_t port_d = 2;
+
+    /*
+    * One pin of one port. Every function is a single sbi/cbi/sbic on
+    * the port registers instead of the pin table lookups done by
+    * digitalRead/digitalWrite/pinMode, so they are cheap enough for
+    * the isrs.
+    */
+    template <uint8_t Port, uint8_t Bit>
+    struct Pin {
+        static_assert(Port <= port_d && Bit < 8, "no such pin");
+
+        static const uint8_t port = Port;
+        static const uint8_t mask = 1 << Bit;
+
+        // one bit per board pin, used to find signals sharing a pin
+        static const uint32_t board_mask = 1UL << (Port * 8 + Bit);
+
+        // arduino pin number, for the core and library calls
+        static const uint8_t number =
+            (Port == port_d) ? Bit : (Port == port_b) ? 8 + Bit : 14 + Bit;
+
+        static bool read()          { return _SFR_IO8(pin_reg) & mask; }
+        static void high()          { _SFR_IO8(port_reg) |= mask; }
+        static void low()           { _SFR_IO8(port_reg) &= ~mask; }
+        static void input()         { _SFR_IO8(ddr_reg) &= ~mask; _SFR_IO8(port_reg) &= ~mask; }
+        static void input_pullup()  { _SFR_IO8(ddr_reg) &= ~mask; _SFR_IO8(port_reg) |= mask; }
+        static void output()        { _SFR_IO8(ddr_reg) |= mask; }
+
+        // pin change interrupt, PCINTn_vect with n = Port
+        static void enable_pcint() {
+            _SFR_MEM8(pcmsk_reg) |= mask;
+            PCICR |= _BV(Port);
+        }
+
+    private:
+        static const uint8_t pin_reg   = 0x03 + 3 * Port;
+        static const uint8_t ddr_reg   = pin_reg + 1;
+        static const uint8_t port_reg  = pin_reg + 2;
+        static const uint8_t pcmsk_reg = 0x6B + Port;
+    };
+
+    // true when no two of the pins are the same
+    template <class... Pins>
+    struct Distinct {
+        static const uint32_t mask = 0;
+        static const bool value = true;
+    };
+
+    template <class P, class... Rest>
+    struct Distinct<P, Rest...> {
+        static const uint32_t mask = Distinct<Rest...>::mask | P::board_mask;
+        static const bool value = Distinct<Rest...>::value && !(Distinct<Rest...>::mask & P::board_mask);
+    };
+
+    /******************************* signals *******************************/
+    // rotary encoder, clk needs an external interrupt (INT0/INT1)
+    typedef Pin<port_d, 2> ReClk;
+    typedef Pin<port_d, 3> ReDt;
+    typedef Pin<port_d, 4> ReSw;
+
+    // joysticks, the axes are read by the adc
+    typedef Pin<port_c, 0> J1X;
+    typedef Pin<port_c, 1> J1Y;
+    typedef Pin<port_c, 2> J2X;
+    typedef Pin<port_c, 3> J2Y;
+    typedef Pin<port_d, 5> J1Sw;
+    typedef Pin<port_d, 6> J2Sw;
+
+    // nRF24, irq (active low), csn and ce, then the hardware spi pins
+    typedef Pin<port_b, 0> RadioIrq;
+    typedef Pin<port_b, 1> RadioCsn;
+    typedef Pin<port_b, 2> RadioCe;
+    typedef Pin<port_b, 3> SpiMosi;
+    typedef Pin<port_b, 4> SpiMiso;
+    typedef Pin<port_b, 5> SpiSck;
+
+    // i2c bus, lcd and mpu-6050
+    typedef Pin<port_c, 4> I2cSda;
+    typedef Pin<port_c, 5> I2cScl;
+
+    static_assert(Distinct<ReClk, ReDt, ReSw,
+                           J1X, J1Y, J2X, J2Y, J1Sw, J2Sw,
+                           RadioIrq, RadioCsn, RadioCe, SpiMosi, SpiMiso, SpiSck,
+                           I2cSda, I2cScl>::value,
+                  "two board signals share a pin");
+    static_assert(ReClk::number == 2 || ReClk::number == 3,
+                  "rot enc clk must be on an external interrupt pin");
+    static_assert(J1X::port == port_c && J1Y::port == port_c &&
+                  J2X::port == port_c && J2Y::port == port_c,
+                  "joystick axes must be on adc pins");
+}
@@ -0,0 +1,158 @@
+/**
+ * @file Boot.cpp
+ *
+ * @brief Init sequencer definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "Boot.h"
+#include "Globals.h"
+#include "Configurations.h"
+#include "ProcessDataOut.h"
+#include "Protothread.h"
+#include "I2cArbiter.h"
+#include "RadioTx.h"
+#include "Control.h"
+#include "Power.h"
+#include "Deadline.h"
+
+namespace Boot {
+    const uint8_t stage_count = static_cast<uint8_t>(Stage::STAGE_COUNT);
+    const uint16_t pending = 0xFFFF;
+
+    // state
+    uint16_t _ready_ms[stage_count] = { pending, pending, pending, pending };
+    bool _reported = false;
+    Pt _imu_pt;
+
+    // set while a blocking init runs the control path from its delays
+    bool _blocking = false;
+
+    // helper functions prototypes
+    void mark(Stage stage);
+    void print_ms(Stage stage);
+    void background();
+
+    uint16_t ready_ms(Stage stage) {
+        return _ready_ms[static_cast<uint8_t>(stage)];
+    }
+
+    bool ready(Stage stage) {
+        return ready_ms(stage) != pending;
+    }
+
+    /*********************************************************************
+    * @fn                - config_boot
+    *
+    * @brief             - wakes the mpu-6050 up and hands the i2c bus
+    *                      to the arbiter
+    *
+    * @param[in]         - none
+    *
+    * @return            - none
+    *
+    * @Note              - call at the end of setup, once the radio, the
+    *                      inputs and the control timer are running. The
+    *                      imu job is only registered once calibrated
+    *********************************************************************/
+    void config_boot() {
+        if (InputProfile::has(InputProfile::IMU)) {
+            config_mpu_6050(Globals::mpu_addr, Globals::pwr_mgmt_1, Globals::start_data_addr);
+        }
+        I2cArbiter::config_bus(nullptr);
+        PT_INIT(&_imu_pt);
+
+        Serial.println(F("    Boot sequencer config complete!"));
+    }
+
+    /*********************************************************************
+    * @fn                - run
+    *
+    * @brief             - brings the slow peripherals up, one step per
+    *                      loop
+    *
+    * @param[in]         - reference to lcd object
+    *
+    * @return            - none
+    *
+    * @Note              - the mpu-6050 goes first, its calibration is one
+    *                      read per loop. The lcd library then waits over a
+    *                      second in delay(), frames keep going out from
+    *                      yield() meanwhile. Prints the boot times once
+    *                      everything is up, the imu stays pending when
+    *                      the input profile has none
+    *********************************************************************/
+    void run(LiquidCrystal_I2C& lcd) {
+        if (!ready(Stage::CONTROL)) mark(Stage::CONTROL);
+        if (!ready(Stage::FIRST_FRAME) && RadioTx::queued()) mark(Stage::FIRST_FRAME);
+        if (_reported) return;
+
+        // tilt feeds the control frames, the lcd only the ui
+        if (InputProfile::has(InputProfile::IMU) && !ready(Stage::IMU)) {
+            if (calibrate_mpu_6050(&_imu_pt) == PtState::ENDED) {
+                I2cArbiter::imu_job(sample_mpu_6050);
+                mark(Stage::IMU);
+            }
+            return;
+        }
+
+        if (!ready(Stage::LCD)) {
+            _blocking = true;
+            I2cArbiter::begin(I2cArbiter::Client::LCD);
+            config_display(lcd);
+            I2cArbiter::end(I2cArbiter::Client::LCD);
+            _blocking = false;
+            mark(Stage::LCD);
+
+            // not a late iteration, the control path ran all along
+            Deadline::begin();
+        }
+
+        _reported = true;
+        print();
+    }
+
+    void print() {
+        Serial.print(F("boot: control="));  print_ms(Stage::CONTROL);
+        Serial.print(F(" frame="));         print_ms(Stage::FIRST_FRAME);
+        Serial.print(F(" imu="));           print_ms(Stage::IMU);
+        Serial.print(F(" lcd="));           print_ms(Stage::LCD);
+        Serial.println();
+    }
+
+    // helper functions
+    void mark(Stage stage) {
+        unsigned long now = millis();
+        _ready_ms[static_cast<uint8_t>(stage)] = (now < pending) ? now : pending - 1;
+    }
+
+    void print_ms(Stage stage) {
+        if (!ready(stage)) {
+            Serial.print('-');
+            return;
+        }
+        Serial.print(ready_ms(stage));
+        Serial.print(F("ms"));
+    }
+
+    // the control part of the loop, without the ui and the pairing
+    void background() {
+        if (!_blocking) return;
+
+        RadioTx::service(Globals::transmitter);
+        if (Control::update(Globals::data_pkg) && Power::send_due(Globals::transmitter) &&
+            send_data(Globals::transmitter, Globals::data_pkg)) {
+            Power::sent(Globals::transmitter);
+        }
+        if (!ready(Stage::FIRST_FRAME) && RadioTx::queued()) mark(Stage::FIRST_FRAME);
+        Deadline::poll();
+    }
+}
+
+// delay() calls yield() while it waits, this replaces the empty one
+// of the core so a blocking init does not stop the frames
+void yield() {
+    Boot::background();
+}
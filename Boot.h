@@ -0,0 +1,33 @@
+/**
+ * @file Boot.h
+ *
+ * @brief Init sequencer, the control path comes up in setup and the
+ *        slow peripherals join from the loop while frames go out
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <LiquidCrystal_I2C.h>
+
+namespace Boot {
+    enum class Stage : uint8_t {
+        CONTROL,        // radio, inputs and control timer, first loop
+        FIRST_FRAME,    // first frame queued for a vehicle
+        IMU,            // mpu-6050 calibrated, if in the input profile
+        LCD,            // lcd initialized, the ui starts
+        STAGE_COUNT
+    };
+
+    // millis since power on, 0xFFFF while pending
+    uint16_t ready_ms(Stage stage);
+    bool ready(Stage stage);
+
+    // utility functions
+    void config_boot();
+    void run(LiquidCrystal_I2C& lcd);
+
+    void print();
+}
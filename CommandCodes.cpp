@@ -0,0 +1,41 @@
+/**
+ * @file CommandCodes.cpp
+ *
+ * @brief Command messages definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "CommandCodes.h"
+
+const char command_msgs[][16] PROGMEM = {
+    "",
+    "OP MAN CMD SENT",
+    "OP AUT CMD SENT",  
+    "RET HM CMD SENT",
+    "LT ON CMD SENT",
+    "LT OFF CMD SENT",
+    "LT AUT CMD SENT"
+};
+
+static_assert(sizeof(command_msgs) / sizeof(command_msgs[0]) == command_count,
+              "one message per command code");
+
+/*********************************************************************
+* @fn                - command_msg
+*
+* @brief             - copies a command message from flash
+*
+* @param[in]         - command code (index into command_msgs)
+* @param[out]        - destination buffer, at least 16 bytes
+*
+* @return            - none
+*
+* @Note              - unknown codes produce an empty message
+*********************************************************************/
+void command_msg(uint8_t code, char* buf) {
+    if (code >= sizeof(command_msgs) / sizeof(command_msgs[0])) {
+        code = static_cast<uint8_t>(CommandCodes::NONE);
+    }
+    strncpy_P(buf, command_msgs[code], sizeof(command_msgs[0]));
+}
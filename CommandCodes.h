@@ -1,3 +1,16 @@
+/**
+ * @file CommandCodes.h
+ *
+ * @brief Command codes sent to the vehicle and their display messages
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
 enum class CommandCodes : uint8_t {
     // no code
     /*0*/NONE,
@@ -15,12 +28,11 @@ enum class CommandCodes : uint8_t {
     /*6*/LIGHTS_AUTO      
 };
 
-char command_msgs[][16] = {
-    "",
-    "OP MAN CMD SENT",
-    "OP AUT CMD SENT",  
-    "RET HM CMD SENT",
-    "LT ON CMD SENT",
-    "LT OFF CMD SENT",
-    "LT AUT CMD SENT"
-};
+// number of codes, the vehicle rejects anything above
+const uint8_t command_count = static_cast<uint8_t>(CommandCodes::LIGHTS_AUTO) + 1;
+
+// flash resident messages, indexed by command code
+extern const char command_msgs[][16] PROGMEM;
+
+// copies the message of the given command code into buf (16 bytes)
+void command_msg(uint8_t code, char* buf);
@@ -9,23 +9,23 @@
 #include "Configurations.h"
 #include "LcdCustomCharacters.h"
 #include "Mpu6050.h"
+#include "Display.h"
+#include "GlyphCache.h"
+#include "Events.h"
+#include "I2cArbiter.h"
+#include <util/atomic.h>
 
 // mpu-6050 local variables
 int16_t acc_buffer = 180;
-struct MpuRawData {
-    int16_t x_acc;
-    int16_t y_acc;
-    int16_t z_acc;
-    int16_t temp;
-    int16_t x_gyro;
-    int16_t y_gyro;
-    int16_t z_gyro;
-};
+
+// readings settle after the wake up, then the resting range is
+// measured over this many samples
+const uint8_t mpu_wake_ms = 30;
+const uint8_t mpu_calibration_samples = 255;
 
 // helper functions prototypes
-void read_mpu_6050_raw(MpuRawData& data);
+void read_mpu_6050_raw(Mpu6050::RawData& data);
 void init_mpu_6050();
-void calibrate_mpu_6050();
 
 
 /*********************************************************************
@@ -43,45 +43,14 @@ void calibrate_mpu_6050();
 *********************************************************************/
 void config_radio(RF24& radio, const uint64_t address) {
 	radio.begin();
+	// vehicle telemetry comes back in the ack payloads
+	radio.enableDynamicPayloads();
+	radio.enableAckPayload();
 	radio.openWritingPipe(address);
+	radio.setDataRate(RF24_1MBPS);
 	radio.setPALevel(RF24_PA_MIN);
 	radio.stopListening();
-	Serial.println("    Radio config complete!");
-}
-
-/*********************************************************************
-* @fn                - config_joystick
-*
-* @brief             - initializes and starts joystick
-*
-* @param[in]         - joystick handle
-* @param[in]         - x axis pin number
-* @param[in]         - x axis pin mode
-* @param[in]         - y axis pin number
-* @param[in]         - y axis pin mode
-* @param[in]         - sw pin number
-* @param[in]         - sw pin mode
-* 
-* @return            - none
-*
-* @Note				 - none
-*********************************************************************/
-void config_joystick(Joystick& j,
-    const uint8_t vrx_pin, const uint8_t vrx_mode,
-	const uint8_t vry_pin, const uint8_t vry_mode,
-	const uint8_t sw_pin, const uint8_t sw_mode) {
-
-    // link pins to joystick handle structure
-    j.vrx_pin = vrx_pin;
-    j.vry_pin = vry_pin;
-    j.sw_pin = sw_pin;
-    
-	// config pins
-	pinMode(vrx_pin, vrx_mode); 
-	pinMode(vry_pin, vry_mode);
-	pinMode(sw_pin, sw_mode);
-
-	Serial.println("    Joysticks config complete!");
+	Serial.println(F("    Radio config complete!"));
 }
 
 /*********************************************************************
@@ -98,40 +67,40 @@ void config_joystick(Joystick& j,
 void config_display(LiquidCrystal_I2C& lcd) {
 	lcd.init();
 	lcd.backlight();
-	lcd.createChar(0, select_arrow);
-    lcd.createChar(1, back_arrow);
-    lcd.createChar(2, thermometer);
-    lcd.createChar(3, battery);
-    lcd.createChar(4, dot);
-    lcd.createChar(5, percent);
-    lcd.createChar(6, sun);
-    lcd.createChar(7, blank);
 	lcd.clear();
-	lcd.setCursor(0, 1);
-	lcd.write(0);
-	lcd.setCursor(0, 0);
+
+	// glyphs are uploaded when a page first needs them
+	GlyphCache::reset();
+
+	// the lcd is blank now, draw the splash through the display buffer
+	Display::invalidate();
+	Display::clear();
+	Display::glyph(0, 1, SELECT_ARROW);
 	/* temp menu,to be updated once it's defined */
-	lcd.print("EXP. VEHICLE  0C");
-	lcd.setCursor(2, 1);
-	lcd.print("LIGHTS ON/OFF");
+	Display::print_P(0, 0, PSTR("EXP. VEHICLE  0C"));
+	Display::print_P(2, 1, PSTR("LIGHTS ON/OFF"));
 	/*********************************************/
+	while (Display::flush_chunk(lcd));
+
+	// the main menu replaces the splash on the first loop
+	Events::post_refresh();
 
-	Serial.println("    Display config complete!");
+	Serial.println(F("    Display config complete!"));
 }
 
 /*********************************************************************
 * @fn                - config_mpu_6050
 *
-* @brief             - wake up and initial calibration of mpu-6050
+* @brief             - wake up of mpu-6050
 *
-* @param[in]         - mpu handle
 * @param[in]         - address to the mpu module
 * @param[in]         - address to power management 1 register
 * @param[in]         - start address of data register
 *
 * @return            - none
 *
-* @Note				 - none
+* @Note				 - calibrate_mpu_6050 measures the resting range
+*                      afterwards, from the loop
 *********************************************************************/
 void config_mpu_6050(
     const uint8_t mpu_addr, 
@@ -146,14 +115,63 @@ void config_mpu_6050(
 	// initialize
 	init_mpu_6050();
 
-	// calibrate
-	calibrate_mpu_6050();
+	Serial.println(F("    MPU-6050 config complete!"));
+}
 
-	Serial.println("    MPU-6050 config complete!");
+/*********************************************************************
+* @fn                - calibrate_mpu_6050
+*
+* @brief             - measures the range the mpu-6050 oscillates in
+*                      at rest
+*
+* @param[in]         - flow state
+*
+* @return            - ENDED once the range is set
+*
+* @Note              - one read per call, so the control frames keep
+*                      going out while it runs. The control isr already
+*                      runs too, the range only applies at the end
+*********************************************************************/
+PtState calibrate_mpu_6050(Pt* pt) {
+    static int16_t min_x, max_x, min_y, max_y;
+    static uint8_t taken;
+    Mpu6050::RawData mpu_raw_data;
+
+    PT_BEGIN(pt);
+    PT_SLEEP(pt, mpu_wake_ms);
+
+    min_x = Mpu6050::min_x_acc();
+    max_x = Mpu6050::max_x_acc();
+    min_y = Mpu6050::min_y_acc();
+    max_y = Mpu6050::max_y_acc();
+    for (taken = 0; taken < mpu_calibration_samples; ++taken) {
+        I2cArbiter::begin(I2cArbiter::Client::IMU);
+        read_mpu_6050_raw(mpu_raw_data);
+        I2cArbiter::end(I2cArbiter::Client::IMU);
+
+        // left / right
+        min_x = min(min_x, mpu_raw_data.x_acc);
+        max_x = max(max_x, mpu_raw_data.x_acc);
+
+        // forward / backward
+        min_y = min(min_y, mpu_raw_data.y_acc);
+        max_y = max(max_y, mpu_raw_data.y_acc);
+        PT_YIELD(pt);
+    }
+
+    // once the range is established, we add a small buffer
+    // to help minimize false readings
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        Mpu6050::min_x_acc(min_x - acc_buffer);
+        Mpu6050::max_x_acc(max_x + acc_buffer);
+        Mpu6050::min_y_acc(min_y - acc_buffer);
+        Mpu6050::max_y_acc(max_y + acc_buffer);
+    }
+    PT_END(pt);
 }
 
 // helper functions 
-void read_mpu_6050_raw(MpuRawData& data) {
+void read_mpu_6050_raw(Mpu6050::RawData& data) {
     Wire.beginTransmission(Mpu6050::device_addr());
     Wire.write(Mpu6050::start_data_addr());  // starting with register 0x3B (ACCEL_XOUT_H)
     Wire.endTransmission(false);
@@ -175,26 +193,3 @@ void init_mpu_6050() {
     Wire.endTransmission(true);
 }
 
-void calibrate_mpu_6050() {
-    // used to calculate oscillating range
-    MpuRawData mpu_raw_data;
-    for (uint8_t i = 0; i < 255; ++i) {
-        // read data
-        read_mpu_6050_raw(mpu_raw_data);
-
-        // left / right
-        Mpu6050::min_x_acc(min(Mpu6050::min_x_acc(), mpu_raw_data.x_acc));
-        Mpu6050::max_x_acc(max(Mpu6050::max_x_acc(), mpu_raw_data.x_acc));
-
-        // forward / backward
-        Mpu6050::min_y_acc(min(Mpu6050::min_y_acc(), mpu_raw_data.y_acc));
-        Mpu6050::max_y_acc(max(Mpu6050::max_y_acc(), mpu_raw_data.y_acc));
-    }
-    // once the range is established, we add a small buffer
-    // to help minimize false readings
-    Mpu6050::min_x_acc(Mpu6050::min_x_acc() - acc_buffer);
-    Mpu6050::max_x_acc(Mpu6050::max_x_acc() + acc_buffer);
-    
-    Mpu6050::min_y_acc(Mpu6050::min_y_acc() - acc_buffer);
-    Mpu6050::max_y_acc(Mpu6050::max_y_acc() + acc_buffer);
-}
@@ -8,18 +8,45 @@
  */
 #pragma once
 
+#include "Arduino.h"
 #include <LiquidCrystal_I2C.h>
 #include <RF24.h>
 #include <nRF24L01.h>
 #include "Joystick.h"
 #include "Mpu6050.h"
+#include "Board.h"
+#include "Protothread.h"
+
+// margin added around the calibrated tilt range
+extern int16_t acc_buffer;
 
 void config_radio(RF24& radio, const uint64_t address);
 
-void config_joystick(Joystick& j,
-    const uint8_t vrx_pin, const uint8_t vrx_mode,
-	const uint8_t vry_pin, const uint8_t vry_mode,
-	const uint8_t sw_pin, const uint8_t sw_mode);
+/*********************************************************************
+* @fn                - config_joystick
+*
+* @brief             - initializes and starts joystick
+*
+* @param[in]         - joystick handle
+*
+* @return            - none
+*
+* @Note              - X, Y and Sw are the Board pins of the x axis,
+*                      y axis and switch
+*********************************************************************/
+template <class X, class Y, class Sw>
+void config_joystick(Joystick& j) {
+    // link adc pins to joystick handle structure
+    j.vrx_pin = X::number;
+    j.vry_pin = Y::number;
+
+    // config pins
+    X::input();
+    Y::input();
+    Sw::input_pullup();
+
+    Serial.println(F("    Joysticks config complete!"));
+}
 
 void config_display(LiquidCrystal_I2C& lcd);
 
@@ -27,3 +54,5 @@ void config_mpu_6050(
     const uint8_t mpu_addr, 
     const uint8_t pwr_mgmt_reg, 
     const uint8_t data_addr);
+
+PtState calibrate_mpu_6050(Pt* pt);
@@ -0,0 +1,218 @@
+/**
+ * @file Control.cpp
+ *
+ * @brief Fixed-rate control path definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "Control.h"
+#include "ProcessDataOut.h"
+#include "Latency.h"
+#include "Seqlock.h"
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+namespace Control {
+    // timer1 runs at 16MHz / 64, 250 counts per millisecond
+    const uint16_t counts_per_ms = 250;
+
+    // frame published by the isr, with the time its inputs were sampled
+    struct Snapshot {
+        DataPackage pkg;
+        unsigned long sampled_us;
+    };
+
+    // latest mpu-6050 sample handed over by the main loop, which owns
+    // the i2c bus. Written to the slot the isr is not reading, then
+    // the index is flipped, the isr always preempts the loop so it
+    // never sees a half written slot
+    struct MpuSlot {
+        Mpu6050::RawData raw;
+        bool valid;
+    };
+
+    // settings
+    uint8_t _period_ms = 10;
+
+    // counters
+    volatile uint32_t _ticks = 0;
+    volatile uint16_t _overruns = 0;
+    volatile uint16_t _max_tick_us = 0;
+
+    // isr side: frame being built and the published snapshot
+    DataPackage _work;
+    Seqlock<Snapshot> _snapshot;
+    volatile bool _busy = false;
+
+    // loop side: version of the last snapshot taken
+    uint8_t _taken = 0;
+
+    MpuSlot _mpu[2];
+    volatile uint8_t _mpu_idx = 0;
+
+    // helper functions prototypes
+    void tick();
+
+    /********* settings api *********/
+    uint8_t period_ms() {
+        return _period_ms;
+    }
+
+    void period_ms(uint8_t val) {
+        if (val == 0) val = 1;
+        _period_ms = val;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            OCR1A = val * counts_per_ms - 1;
+            TCNT1 = 0;
+        }
+    }
+
+    /********* counters api *********/
+    uint32_t ticks() {
+        uint32_t val;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            val = _ticks;
+        }
+        return val;
+    }
+
+    uint16_t overruns() {
+        uint16_t val;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            val = _overruns;
+        }
+        return val;
+    }
+
+    uint16_t max_tick_us() {
+        uint16_t val;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            val = _max_tick_us;
+        }
+        return val;
+    }
+
+    /*********************************************************************
+    * @fn                - config_control
+    *
+    * @brief             - starts the control timer
+    *
+    * @param[in]         - frame with the joystick pins set up
+    *
+    * @return            - none
+    *
+    * @Note              - timer1 in ctc mode, call once the joysticks
+    *                      are configured, tilt reads as rest until the
+    *                      mpu-6050 hands in samples
+    *********************************************************************/
+    void config_control(const DataPackage& data_pkg) {
+        _work = data_pkg;
+        _mpu[0].valid = false;
+        _mpu[1].valid = false;
+
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            TCCR1A = 0;
+            TCCR1B = _BV(WGM12) | _BV(CS11) | _BV(CS10);
+            OCR1A = _period_ms * counts_per_ms - 1;
+            TCNT1 = 0;
+            TIFR1 = _BV(OCF1A);
+            TIMSK1 |= _BV(OCIE1A);
+        }
+
+        Serial.println(F("    Control timer config complete!"));
+    }
+
+    /*********************************************************************
+    * @fn                - mpu_sample
+    *
+    * @brief             - hands the latest mpu-6050 sample to the isr
+    *
+    * @param[in]         - raw sample, nullptr if the read failed
+    *
+    * @return            - none
+    *
+    * @Note              - main loop only
+    *********************************************************************/
+    void mpu_sample(const Mpu6050::RawData* raw) {
+        MpuSlot& slot = _mpu[_mpu_idx ^ 1];
+        slot.valid = (raw != nullptr);
+        if (raw != nullptr) slot.raw = *raw;
+
+        // the slot must be complete before the isr can pick it
+        __asm__ __volatile__("" ::: "memory");
+        _mpu_idx ^= 1;
+    }
+
+    // true when the isr built a frame update has not taken yet
+    bool pending() {
+        return _snapshot.version() != _taken;
+    }
+
+    /*********************************************************************
+    * @fn                - update
+    *
+    * @brief             - copies the inputs of the newest frame
+    *
+    * @param[out]        - frame to update, menu_select is left as is
+    *
+    * @return            - true if the isr built a frame since the last
+    *                      call
+    *
+    * @Note              - main loop only, never blocks on the isr
+    *********************************************************************/
+    bool update(DataPackage& data_pkg) {
+        Snapshot snap;
+        uint8_t version = _snapshot.read(snap);
+        if (version == _taken) return false;
+        _taken = version;
+
+        if (InputProfile::has(InputProfile::J1)) data_pkg.j1 = snap.pkg.j1;
+        if (InputProfile::has(InputProfile::J2)) data_pkg.j2 = snap.pkg.j2;
+        if (InputProfile::has(InputProfile::IMU)) data_pkg.mpu = snap.pkg.mpu;
+        Latency::sampled(snap.sampled_us);
+        return true;
+    }
+
+    void print() {
+        Serial.print(F("control: ticks="));  Serial.print(ticks());
+        Serial.print(F(" period="));         Serial.print(_period_ms);
+        Serial.print(F("ms max="));          Serial.print(max_tick_us());
+        Serial.print(F("us overruns="));     Serial.println(overruns());
+    }
+
+    // helper functions
+    void tick() {
+        Snapshot snap;
+        snap.sampled_us = micros();
+
+        // inputs outside the profile are never sampled
+        if (InputProfile::has(InputProfile::J1)) process_joystick_alt(_work.j1);
+        if (InputProfile::has(InputProfile::J2)) process_joystick(_work.j2);
+        if (InputProfile::has(InputProfile::IMU)) {
+            const MpuSlot& slot = _mpu[_mpu_idx];
+            process_mpu_6050(_work.mpu, slot.valid ? &slot.raw : nullptr);
+        }
+
+        snap.pkg = _work;
+        _snapshot.write(snap);
+
+        unsigned long elapsed = micros() - snap.sampled_us;
+        if (elapsed > _max_tick_us) _max_tick_us = (elapsed > 0xFFFF) ? 0xFFFF : elapsed;
+        ++_ticks;
+    }
+}
+
+// control tick, interrupts stay enabled so the encoder, the radio irq
+// and millis() are not held up by the adc reads
+ISR(TIMER1_COMPA_vect, ISR_NOBLOCK) {
+    // a tick longer than the period would nest, skip it instead
+    if (Control::_busy) {
+        ++Control::_overruns;
+        return;
+    }
+    Control::_busy = true;
+    Control::tick();
+    Control::_busy = false;
+}
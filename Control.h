@@ -0,0 +1,33 @@
+/**
+ * @file Control.h
+ *
+ * @brief Fixed-rate control path, inputs are sampled and the frame is
+ *        built from a timer interrupt, independent of the ui
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include "DataPackage.h"
+#include "Mpu6050.h"
+
+namespace Control {
+    /********* settings api *********/
+    uint8_t period_ms();
+    void period_ms(uint8_t val);
+
+    /********* counters api *********/
+    uint32_t ticks();
+    uint16_t overruns();
+    uint16_t max_tick_us();
+
+    // utility functions
+    void config_control(const DataPackage& data_pkg);
+    void mpu_sample(const Mpu6050::RawData* raw);
+    bool pending();
+    bool update(DataPackage& data_pkg);
+
+    void print();
+}
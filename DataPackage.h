@@ -1,13 +1,131 @@
 #pragma once
 
+#include <stddef.h>
+#include <string.h>
 #include "Joystick.h"
 #include "Mpu6050.h"
+#include "InputProfile.h"
     
+// every input of every profile, only the header and the inputs of the
+// profile go on the air (pack_frame)
 struct DataPackage {
+    // InputProfile::Id the frame was packed with
+    uint8_t profile;
+
+    uint8_t menu_select;
+
+    // downlink state of the vehicle the frame goes to, newest ack
+    // payload decoded and one bit per earlier one (see Downlink.h)
+    uint8_t ack_seq;
+    uint8_t ack_bits;
+
+    // transmitter time when the frame was sent (Latency::stamp)
+    uint16_t tx_stamp;
+
     Joystick j1;
     Joystick j2;
     
     Mpu6050::Instance mpu;
+};
 
-    uint8_t menu_select;
+// bytes of each part of a frame, the joystick pins stay off the air
+const uint8_t frame_header_len = offsetof(DataPackage, j1);
+const uint8_t joystick_len = offsetof(Joystick, vrx_pin);
+const uint8_t mpu_len = sizeof(Mpu6050::Instance);
+
+// frame length of a profile, motion block excluded
+constexpr uint8_t frame_len(uint8_t profile) {
+    return frame_header_len
+        + ((InputProfile::inputs(profile) & InputProfile::J1) ? joystick_len : 0)
+        + ((InputProfile::inputs(profile) & InputProfile::J2) ? joystick_len : 0)
+        + ((InputProfile::inputs(profile) & InputProfile::IMU) ? mpu_len : 0);
+}
+
+const uint8_t max_frame_len = frame_len(InputProfile::FULL);
+
+/*********************************************************************
+* @fn                - pack_frame
+*
+* @brief             - lays a frame out for the air
+*
+* @param[in]         - frame
+* @param[out]        - payload, at least frame_len(Profile) bytes
+*
+* @return            - payload length, frame_len(Profile)
+*
+* @Note              - Profile is the active one on the transmitter,
+*                      the checks are constant so only the copies of
+*                      its inputs are compiled
+*********************************************************************/
+template <uint8_t Profile = InputProfile::active>
+uint8_t pack_frame(const DataPackage& pkg, uint8_t* out) {
+    const uint8_t inputs = InputProfile::inputs(Profile);
+    uint8_t len = frame_header_len;
+
+    memcpy(out, &pkg, frame_header_len);
+    out[0] = Profile;
+    if (inputs & InputProfile::J1) {
+        memcpy(out + len, &pkg.j1, joystick_len);
+        len += joystick_len;
+    }
+    if (inputs & InputProfile::J2) {
+        memcpy(out + len, &pkg.j2, joystick_len);
+        len += joystick_len;
+    }
+    if (inputs & InputProfile::IMU) {
+        memcpy(out + len, &pkg.mpu, mpu_len);
+        len += mpu_len;
+    }
+    return len;
+}
+
+// compact imu sample packed after the frame in motion frame mode
+struct MotionSample {
+    // raw acceleration >> 8
+    int8_t x_acc;
+    int8_t y_acc;
+
+    // how long before tx_stamp the sample was taken, in units of
+    // 64 stamp ticks (256us), saturated at 255
+    uint8_t age;
+};
+
+const uint8_t max_motion_samples = 3;
+
+struct MotionBlock {
+    uint8_t count;
+    MotionSample samples[max_motion_samples];
+};
+
+// bytes a motion block with count samples takes in the payload
+inline uint8_t motion_block_len(uint8_t count) {
+    return sizeof(MotionBlock::count) + count * sizeof(MotionSample);
+}
+
+// the parts go on the air as they are laid out, both sides (and the
+// host loopback build) must lay them out the same, without padding
+static_assert(frame_header_len == 6 && offsetof(DataPackage, tx_stamp) == 4,
+              "frame header layout changed, update the vehicle too");
+static_assert(joystick_len == 4 && mpu_len == 5 && max_frame_len == 19,
+              "input layout changed, update the vehicle too");
+static_assert(sizeof(MotionSample) == 3 && sizeof(MotionBlock) == 10,
+              "motion block layout changed, update the vehicle too");
+
+// nrf24 payloads are limited to 32 bytes, a motion block goes after
+// the frame
+static_assert(max_frame_len + sizeof(MotionBlock) <= 32, "motion frame does not fit a payload");
+
+// payload the vehicle attaches to its acks
+struct AckPackage {
+    // tx_stamp of the previous frame received by the vehicle
+    uint16_t echo_stamp;
+
+    // vehicle time between that frame and the current one, in stamp
+    // ticks, 0 when there is nothing to echo yet
+    uint16_t hold;
+
+    // multiplexed telemetry channels, see Downlink.h
+    int8_t telemetry[28];
 };
+
+const uint8_t ack_header_size = offsetof(AckPackage, telemetry);
@@ -0,0 +1,255 @@
+/**
+ * @file Deadline.cpp
+ *
+ * @brief Loop deadline monitor, watchdog and fail-safe neutral
+ *        frames definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "Deadline.h"
+#include "DataPackage.h"
+#include "Fleet.h"
+#include "Latency.h"
+#include "Power.h"
+#include "RadioTx.h"
+#include "Trace.h"
+#include <Wire.h>
+#include <avr/wdt.h>
+
+// reset cause, saved before the runtime clears memory (.noinit)
+uint8_t reset_flags __attribute__((section(".noinit")));
+
+// helper functions prototypes
+void save_reset_flags() __attribute__((naked, used, section(".init3")));
+
+namespace Deadline {
+    // i2c transactions give up after this long (LCD and MPU-6050)
+    const uint32_t i2c_timeout_us = 3000;
+
+    // settings
+    uint16_t _budget_us = 25000;
+
+    // counters
+    uint32_t _iterations = 0;
+    uint16_t _misses = 0;
+    uint16_t _neutral_frames = 0;
+    uint16_t _i2c_timeouts = 0;
+    uint16_t _max_iteration_us = 0;
+    uint16_t _last_iteration_us = 0;
+    bool _wdt_reset = false;
+
+    // timing
+    unsigned long _iteration_start_us = 0;
+    unsigned long _last_frame_us = 0;
+
+    // frame sent when the loop can not keep up, all inputs at rest
+    DataPackage _neutral;
+    RF24* _radio = nullptr;
+
+    /********* settings api *********/
+    uint16_t budget_us() {
+        return _budget_us;
+    }
+
+    void budget_us(uint16_t val) {
+        _budget_us = val;
+    }
+
+    /********* counters api *********/
+    uint32_t iterations() {
+        return _iterations;
+    }
+
+    uint16_t misses() {
+        return _misses;
+    }
+
+    uint16_t neutral_frames() {
+        return _neutral_frames;
+    }
+
+    uint16_t i2c_timeouts() {
+        return _i2c_timeouts;
+    }
+
+    uint16_t max_iteration_us() {
+        return _max_iteration_us;
+    }
+
+    uint16_t last_iteration_us() {
+        return _last_iteration_us;
+    }
+
+    // starts the counters over, e.g. after a tuning change
+    void reset() {
+        _iterations = 0;
+        _misses = 0;
+        _neutral_frames = 0;
+        _i2c_timeouts = 0;
+        _max_iteration_us = 0;
+    }
+
+    /*********************************************************************
+    * @fn                - config_deadline
+    *
+    * @brief             - prepares the neutral frame, bounds i2c
+    *                      transactions and arms the watchdog
+    *
+    * @param[in]         - reference to radio object (RF24)
+    *
+    * @return            - none
+    *
+    * @Note              - call last in setup(), once the slow one-off
+    *                      initialization is done. The watchdog is off
+    *                      until then, save_reset_flags turned it off
+    *                      before setup() started
+    *********************************************************************/
+    void config_deadline(RF24& radio) {
+        _radio = &radio;
+        memset(&_neutral, 0, sizeof(_neutral));
+
+        // a hung transaction resets the bus instead of blocking forever
+        Wire.setWireTimeout(i2c_timeout_us, true);
+
+        // report if the last reset came from the watchdog
+        _wdt_reset = reset_flags & _BV(WDRF);
+        wdt_enable(WDTO_250MS);
+
+        _last_frame_us = micros();
+        _iteration_start_us = _last_frame_us;
+
+        Serial.println(F("    Deadline monitor config complete!"));
+    }
+
+    /*********************************************************************
+    * @fn                - begin / end
+    *
+    * @brief             - mark the start and the end of a loop iteration
+    *
+    * @param[in]         - none
+    *
+    * @return            - none
+    *
+    * @Note              - time spent sleeping in low power mode is not
+    *                      part of the iteration
+    *********************************************************************/
+    void begin() {
+        _iteration_start_us = micros();
+        Trace::record(Trace::Event::LOOP_BEGIN);
+    }
+
+    void end() {
+        unsigned long elapsed = micros() - _iteration_start_us;
+        ++_iterations;
+        _last_iteration_us = (elapsed > 0xFFFF) ? 0xFFFF : elapsed;
+        if (_last_iteration_us > _max_iteration_us) {
+            _max_iteration_us = _last_iteration_us;
+        }
+        Trace::record(Trace::Event::LOOP_END);
+        if (elapsed > _budget_us) {
+            ++_misses;
+
+            // keep the trace of the late iteration for a dump
+            Trace::record(Trace::Event::DEADLINE_MISS, min(elapsed >> 8, 255UL));
+            Trace::trigger();
+        }
+        wdt_reset();
+    }
+
+    void frame_sent() {
+        _last_frame_us = micros();
+    }
+
+    /*********************************************************************
+    * @fn                - poll
+    *
+    * @brief             - sends the neutral frame if the last frame is
+    *                      older than the budget
+    *
+    * @param[in]         - none
+    *
+    * @return            - none
+    *
+    * @Note              - called from anything that may take long
+    *                      (eeprom writes, blocking inits through yield,
+    *                      the serial dumps) so the vehicle never acts
+    *                      on stale input for more than one budget
+    *********************************************************************/
+    void poll() {
+        wdt_reset();
+        if (_radio == nullptr || Power::idle()) return;
+        if (micros() - _last_frame_us <= _budget_us) return;
+
+        int8_t slot = Fleet::next_slot();
+        if (slot < 0) return;
+
+        // a fresh stamp, or the vehicle would drop it as stale
+        _neutral.tx_stamp = Latency::stamp();
+        uint8_t frame[max_frame_len];
+
+        // held behind a command, which the vehicle is getting anyway,
+        // the next poll tries again
+        if (!RadioTx::send(*_radio, slot, frame, pack_frame(_neutral, frame))) return;
+
+        Trace::record(Trace::Event::NEUTRAL_FRAME);
+        ++_neutral_frames;
+        _last_frame_us = micros();
+    }
+
+    /*********************************************************************
+    * @fn                - check_i2c
+    *
+    * @brief             - counts and clears i2c timeouts
+    *
+    * @param[in]         - none
+    *
+    * @return            - true if a transaction timed out since the
+    *                      last check
+    *
+    * @Note              - none
+    *********************************************************************/
+    bool check_i2c() {
+        if (!Wire.getWireTimeoutFlag()) return false;
+        Wire.clearWireTimeoutFlag();
+        ++_i2c_timeouts;
+        return true;
+    }
+
+    void print() {
+        Serial.print(F("loop: n="));        Serial.print(_iterations);
+        Serial.print(F(" budget="));        Serial.print(_budget_us);
+        Serial.print(F("us max="));         Serial.print(_max_iteration_us);
+        Serial.print(F("us misses="));      Serial.print(_misses);
+        Serial.print(F(" neutral="));       Serial.print(_neutral_frames);
+        Serial.print(F(" i2c timeouts="));  Serial.print(_i2c_timeouts);
+        Serial.print(F(" wdt reset="));     Serial.println(_wdt_reset);
+    }
+}
+
+// helper functions
+/*********************************************************************
+* @fn                - save_reset_flags
+*
+* @brief             - keeps the reset cause and stops the watchdog
+*
+* @param[in]         - none
+*
+* @return            - none
+*
+* @Note              - runs from .init3, before setup(). After a
+*                      watchdog reset WDRF keeps the watchdog on at
+*                      ~16ms until it is cleared, much shorter than
+*                      setup(). Optiboot clears MCUSR itself and hands
+*                      the flags over in r2
+*********************************************************************/
+void save_reset_flags() {
+    uint8_t flags = MCUSR;
+    if (flags == 0) {
+        __asm__ __volatile__ ("mov %0, r2" : "=r" (flags));
+    }
+    reset_flags = flags;
+    MCUSR = 0;
+    wdt_disable();
+}
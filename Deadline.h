@@ -0,0 +1,37 @@
+/**
+ * @file Deadline.h
+ *
+ * @brief Loop deadline monitor, watchdog and fail-safe neutral frames
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <RF24.h>
+
+namespace Deadline {
+    /********* settings api *********/
+    uint16_t budget_us();
+    void budget_us(uint16_t val);
+
+    /********* counters api *********/
+    uint32_t iterations();
+    uint16_t misses();
+    uint16_t neutral_frames();
+    uint16_t i2c_timeouts();
+    uint16_t max_iteration_us();
+    uint16_t last_iteration_us();
+    void reset();
+
+    // utility functions
+    void config_deadline(RF24& radio);
+    void begin();
+    void end();
+    void frame_sent();
+    void poll();
+    bool check_i2c();
+
+    void print();
+}
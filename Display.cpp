@@ -0,0 +1,135 @@
+/**
+ * @file Display.cpp
+ *
+ * @brief Display shadow buffer definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Display.h"
+#include "GlyphCache.h"
+#include <string.h>
+
+namespace Display {
+    // what the page should look like, and what the lcd shows
+    uint8_t _shadow[rows][cols];
+    uint8_t _shown[rows][cols];
+
+    // one bit per column, set when the shadow cell holds a glyph id
+    uint16_t _glyph_cells[rows];
+
+    // index of the first cell that may differ
+    uint8_t _scan = 0;
+
+    // helper functions prototypes
+    uint8_t resolve(LiquidCrystal_I2C& lcd, uint8_t row, uint8_t col);
+
+    void clear() {
+        memset(_shadow, ' ', sizeof(_shadow));
+        memset(_glyph_cells, 0, sizeof(_glyph_cells));
+        _scan = 0;
+
+        // a new page starts, only its own glyphs matter from now on
+        GlyphCache::pin_none();
+    }
+
+    void print(uint8_t col, uint8_t row, const char* text) {
+        while (*text != '\0' && col < cols) {
+            _glyph_cells[row] &= ~(1 << col);
+            _shadow[row][col++] = *text++;
+        }
+        _scan = 0;
+    }
+
+    void print_P(uint8_t col, uint8_t row, PGM_P text) {
+        char c;
+        while ((c = pgm_read_byte(text++)) != '\0' && col < cols) {
+            _glyph_cells[row] &= ~(1 << col);
+            _shadow[row][col++] = c;
+        }
+        _scan = 0;
+    }
+
+    void write(uint8_t col, uint8_t row, uint8_t code) {
+        if (col >= cols) return;
+        _glyph_cells[row] &= ~(1 << col);
+        _shadow[row][col] = code;
+        _scan = 0;
+    }
+
+    void glyph(uint8_t col, uint8_t row, uint8_t id) {
+        if (col >= cols) return;
+        _glyph_cells[row] |= 1 << col;
+        _shadow[row][col] = id;
+        GlyphCache::pin(id);
+        _scan = 0;
+    }
+
+    void invalidate() {
+        // 0xFF never matches a drawn cell
+        memset(_shown, 0xFF, sizeof(_shown));
+        _scan = 0;
+    }
+
+    bool dirty() {
+        return _scan < rows * cols || GlyphCache::stale();
+    }
+
+    /*********************************************************************
+    * @fn                - flush_chunk
+    *
+    * @brief             - writes the next run of changed cells to the lcd
+    *
+    * @param[in]         - reference to lcd object
+    *
+    * @return            - true if something was written, false when the
+    *                      lcd already matches the shadow buffer
+    *
+    * @Note              - only cells that changed are sent, which is
+    *                      what keeps page redraws cheap on the bus, a
+    *                      glyph upload or refresh counts as a chunk too
+    *********************************************************************/
+    bool flush_chunk(LiquidCrystal_I2C& lcd) {
+        // a dynamic glyph changed, its cells show it once uploaded
+        if (GlyphCache::refresh(lcd)) return true;
+
+        uint16_t uploads = GlyphCache::uploads();
+
+        // find the first changed cell
+        while (_scan < rows * cols) {
+            uint8_t row = _scan / cols;
+            uint8_t col = _scan % cols;
+            if (resolve(lcd, row, col) != _shown[row][col]) break;
+            ++_scan;
+        }
+        if (_scan >= rows * cols) return false;
+
+        // resolve the run of changed cells that starts there, glyphs
+        // are uploaded before the cursor is set
+        uint8_t row = _scan / cols;
+        uint8_t col = _scan % cols;
+        uint8_t run[max_chunk];
+        uint8_t len = 0;
+        while (len < max_chunk && col + len < cols) {
+            uint8_t code = resolve(lcd, row, col + len);
+            if (len > 0 && code == _shown[row][col + len]) break;
+            run[len++] = code;
+        }
+
+        lcd.setCursor(col, row);
+        for (uint8_t n = 0; n < len; ++n) {
+            lcd.write(run[n]);
+            _shown[row][col + n] = run[n];
+        }
+
+        // an eviction may have moved glyphs that were already checked
+        _scan = (GlyphCache::uploads() != uploads) ? 0 : row * cols + col + len;
+        return true;
+    }
+
+    // helper functions
+    uint8_t resolve(LiquidCrystal_I2C& lcd, uint8_t row, uint8_t col) {
+        if (!(_glyph_cells[row] & (1 << col))) return _shadow[row][col];
+        return GlyphCache::acquire(lcd, _shadow[row][col]);
+    }
+}
@@ -1 +1,40 @@
+/**
+ * @file Display.h
+ *
+ * @brief Display shadow buffer, pages are drawn in ram and
+ *        flushed to the lcd in small chunks
+ *
+ * @author Gustavo Monardez
+ *
+ */
 #pragma once
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include <LiquidCrystal_I2C.h>
+
+namespace Display {
+    const uint8_t cols = 16;
+    const uint8_t rows = 2;
+
+    // longest run of characters written per chunk
+    const uint8_t max_chunk = 4;
+
+    // drawing, ram only
+    void clear();
+    void print(uint8_t col, uint8_t row, const char* text);
+    void print_P(uint8_t col, uint8_t row, PGM_P text);
+    void write(uint8_t col, uint8_t row, uint8_t code);
+
+    // custom character by glyph id (Symbols), its cgram slot is
+    // resolved through the glyph cache when flushing
+    void glyph(uint8_t col, uint8_t row, uint8_t id);
+
+    // marks every cell as changed, i.e. after the lcd was cleared
+    // or glyphs were reloaded behind our back
+    void invalidate();
+
+    // flushing, one chunk is one setCursor plus up to max_chunk chars
+    bool dirty();
+    bool flush_chunk(LiquidCrystal_I2C& lcd);
+}
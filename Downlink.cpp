@@ -0,0 +1,365 @@
+/**
+ * @file Downlink.cpp
+ *
+ * @brief Telemetry multiplexing definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+// no Arduino.h here, the vehicle side is also built on the host by
+// tools/rx_bench.py
+#include "Downlink.h"
+#include <string.h>
+
+namespace Downlink {
+    // run header fields
+    const uint8_t delta_flag = 0x80;
+    const uint8_t run_shift = 5;
+    const uint8_t channel_mask = 0x1F;
+
+    static_assert(channel_count <= channel_mask + 1, "channel ids take 5 bits");
+
+    // helper functions prototypes
+    bool delta_fits(int8_t val, int8_t base);
+
+    uint8_t next_seq(uint8_t seq) {
+        return (seq == 255) ? 1 : seq + 1;
+    }
+
+    uint8_t seq_distance(uint8_t seq, uint8_t older) {
+        int16_t d = static_cast<int16_t>(seq) - older;
+        return (d < 0) ? d + 255 : d;
+    }
+
+    /********* Scheduler *********/
+    Scheduler::Scheduler() :
+        _used(0), _lost(0), _next_slow(0), _next_sent(0), _base(-1), _seq(0), _stale_ack(0),
+        _payloads(0), _keys(0), _resent(0) {
+        memset(_values, 0, sizeof(_values));
+        memset(_period, slow_period, sizeof(_period));
+        memset(_age, 0xFF, sizeof(_age));
+        memset(_sent, 0, sizeof(_sent));
+    }
+
+    uint8_t Scheduler::period(uint8_t channel) const {
+        return _period[channel];
+    }
+
+    void Scheduler::period(uint8_t channel, uint8_t payloads) {
+        if (channel < channel_count) _period[channel] = payloads ? payloads : 1;
+    }
+
+    int8_t Scheduler::value(uint8_t channel) const {
+        return _values[channel];
+    }
+
+    void Scheduler::value(uint8_t channel, int8_t val) {
+        if (channel >= channel_count) return;
+        _values[channel] = val;
+        _used |= 1U << channel;
+    }
+
+    uint16_t Scheduler::payloads() const {
+        return _payloads;
+    }
+
+    uint16_t Scheduler::keys() const {
+        return _keys;
+    }
+
+    uint16_t Scheduler::resent() const {
+        return _resent;
+    }
+
+    /*********************************************************************
+    * @fn                - acked
+    *
+    * @brief             - takes the ack state of the last frame received
+    *
+    * @param[in]         - newest payload the transmitter decoded
+    * @param[in]         - bit n set if it also got the payload n + 1
+    *                      seqs before that one
+    *
+    * @return            - none
+    *
+    * @Note              - a seq that is no longer in the history (or 0,
+    *                      e.g. the transmitter restarted) leaves no base,
+    *                      the next payload is all absolute
+    *********************************************************************/
+    void Scheduler::acked(uint8_t ack_seq, uint8_t ack_bits) {
+        _base = -1;
+        if (ack_seq == 0 || ack_seq == _stale_ack) return;
+        _stale_ack = 0;
+
+        for (uint8_t i = 0; i < history; ++i) {
+            Sent& s = _sent[i];
+            if (s.seq == 0) continue;
+            if (s.seq == ack_seq) {
+                _base = i;
+                s.checked = true;
+                continue;
+            }
+            if (s.checked) continue;
+
+            // newer payloads are not known about yet
+            uint8_t d = seq_distance(ack_seq, s.seq);
+            if (d >= 128) continue;
+
+            if (d <= 8 && !(ack_bits & (1U << (d - 1)))) {
+                _lost |= s.channels;
+                ++_resent;
+            }
+            s.checked = true;
+        }
+
+        // an ack that fell out of the history must not match the next
+        // payload that reuses its seq, it is ignored until it changes
+        if (_base < 0) _stale_ack = ack_seq;
+    }
+
+    /*********************************************************************
+    * @fn                - encode
+    *
+    * @brief             - builds the next payload
+    *
+    * @param[out]        - payload
+    * @param[in]         - room in the payload, header included
+    *
+    * @return            - payload length
+    *
+    * @Note              - fast channels and channels from lost payloads
+    *                      go first, then due slow channels from where
+    *                      the last payload stopped. Every channel is a
+    *                      delta when it fits a nibble, else absolute
+    *********************************************************************/
+    uint8_t Scheduler::encode(uint8_t* out, uint8_t size) {
+        const int8_t* base = (_base >= 0) ? _sent[_base].snapshot : nullptr;
+        uint16_t channels = 0;
+
+        for (uint8_t ch = 0; ch < channel_count; ++ch) {
+            uint16_t bit = 1U << ch;
+            if (!(_used & bit) || (_period[ch] != 1 && !(_lost & bit))) continue;
+            if (fits(channels | bit, base, size)) channels |= bit;
+        }
+
+        for (uint8_t i = 0; i < channel_count; ++i) {
+            uint8_t ch = _next_slow + i;
+            if (ch >= channel_count) ch -= channel_count;
+            uint16_t bit = 1U << ch;
+            if (!(_used & bit) || (channels & bit) || _age[ch] < _period[ch]) continue;
+            if (!fits(channels | bit, base, size)) {
+                // first in line for the next payload
+                _next_slow = ch;
+                break;
+            }
+            channels |= bit;
+            _next_slow = (ch + 1 < channel_count) ? ch + 1 : 0;
+        }
+
+        _seq = next_seq(_seq);
+        out[0] = _seq;
+        out[1] = base ? _sent[_base].seq : 0;
+        uint8_t len = header_size + pack(channels, base, out + header_size, size - header_size);
+
+        // snapshot the transmitter will hold once it decodes this one
+        Sent& s = _sent[_next_sent];
+        if (base) memmove(s.snapshot, base, sizeof(s.snapshot));
+        else memset(s.snapshot, 0, sizeof(s.snapshot));
+        for (uint8_t ch = 0; ch < channel_count; ++ch) {
+            if (channels & (1U << ch)) s.snapshot[ch] = _values[ch];
+        }
+        s.seq = _seq;
+        s.checked = false;
+        s.channels = channels;
+        if (_base == _next_sent) _base = -1;
+        _next_sent = (_next_sent + 1 < history) ? _next_sent + 1 : 0;
+
+        for (uint8_t ch = 0; ch < channel_count; ++ch) {
+            if (channels & (1U << ch)) _age[ch] = 0;
+            else if (_age[ch] < 0xFF) ++_age[ch];
+        }
+        _lost &= ~channels;
+        ++_payloads;
+        if (!base) ++_keys;
+        return len;
+    }
+
+    uint8_t Scheduler::pack(uint16_t channels, const int8_t* base, uint8_t* out, uint8_t size) const {
+        uint8_t len = 0;
+        uint8_t ch = 0;
+        while (ch < channel_count) {
+            if (!(channels & (1U << ch))) {
+                ++ch;
+                continue;
+            }
+
+            // run of consecutive channels of the same kind
+            bool delta = base && delta_fits(_values[ch], base[ch]);
+            uint8_t n = 1;
+            while (n < max_run && ch + n < channel_count &&
+                   (channels & (1U << (ch + n))) &&
+                   (base && delta_fits(_values[ch + n], base[ch + n])) == delta) {
+                ++n;
+            }
+
+            uint8_t bytes = delta ? (n + 1) / 2 : n;
+            if (len + 1 + bytes > size) return 0xFF;
+            out[len++] = (delta ? delta_flag : 0) | ((n - 1) << run_shift) | ch;
+            if (delta) {
+                memset(out + len, 0, bytes);
+                for (uint8_t k = 0; k < n; ++k) {
+                    uint8_t nibble = (_values[ch + k] - base[ch + k]) & 0x0F;
+                    out[len + k / 2] |= (k & 1) ? nibble << 4 : nibble;
+                }
+            } else {
+                memcpy(out + len, _values + ch, n);
+            }
+            len += bytes;
+            ch += n;
+        }
+        return len;
+    }
+
+    bool Scheduler::fits(uint16_t channels, const int8_t* base, uint8_t size) const {
+        uint8_t buf[32];
+        uint8_t room = size - header_size;
+        if (room > sizeof(buf)) room = sizeof(buf);
+        return pack(channels, base, buf, room) != 0xFF;
+    }
+
+    /********* Decoder *********/
+    Decoder::Decoder() {
+        clear();
+    }
+
+    void Decoder::clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    int8_t* Decoder::values() {
+        return _values;
+    }
+
+    uint8_t Decoder::ack_seq() const {
+        return _ack_seq;
+    }
+
+    uint8_t Decoder::ack_bits() const {
+        return _ack_bits;
+    }
+
+    uint16_t Decoder::incomplete() const {
+        return _incomplete;
+    }
+
+    uint16_t Decoder::invalid() const {
+        return _invalid;
+    }
+
+    /*********************************************************************
+    * @fn                - decode
+    *
+    * @brief             - applies a payload to the channel values
+    *
+    * @param[in]         - payload, AckPackage::telemetry
+    * @param[in]         - payload length
+    *
+    * @return            - false if the payload was malformed, nothing
+    *                      is applied then
+    *
+    * @Note              - deltas against a base that is no longer kept
+    *                      are skipped and the payload is not confirmed,
+    *                      so the vehicle sends those channels again
+    *********************************************************************/
+    bool Decoder::decode(const uint8_t* buf, uint8_t len) {
+        if (len < header_size || buf[0] == 0) {
+            ++_invalid;
+            return false;
+        }
+        uint8_t seq = buf[0];
+        uint8_t base_seq = buf[1];
+
+        // a payload without a base starts over, e.g. the vehicle restarted
+        const int8_t* base = nullptr;
+        int8_t snapshot[channel_count];
+        if (base_seq == 0) {
+            memset(snapshot, 0, sizeof(snapshot));
+            base = snapshot;
+        } else {
+            base = find(base_seq);
+            if (base) memcpy(snapshot, base, sizeof(snapshot));
+        }
+
+        uint16_t channels = 0;
+        bool complete = true;
+        uint8_t i = header_size;
+        while (i < len) {
+            uint8_t header = buf[i++];
+            uint8_t n = ((header >> run_shift) & 0x03) + 1;
+            uint8_t ch = header & channel_mask;
+            bool delta = header & delta_flag;
+            uint8_t bytes = delta ? (n + 1) / 2 : n;
+            if (ch + n > channel_count || i + bytes > len) {
+                ++_invalid;
+                return false;
+            }
+
+            for (uint8_t k = 0; k < n; ++k) {
+                if (!delta) {
+                    snapshot[ch + k] = buf[i + k];
+                } else if (base) {
+                    // sign extend the nibble
+                    int8_t d = ((buf[i + k / 2] >> ((k & 1) * 4)) & 0x0F) << 4;
+                    snapshot[ch + k] = base[ch + k] + (d >> 4);
+                } else {
+                    complete = false;
+                    continue;
+                }
+                channels |= 1U << (ch + k);
+            }
+            i += bytes;
+        }
+
+        for (uint8_t ch = 0; ch < channel_count; ++ch) {
+            if (channels & (1U << ch)) _values[ch] = snapshot[ch];
+        }
+
+        if (!complete || !base) {
+            ++_incomplete;
+            return true;
+        }
+        if (base_seq == 0) {
+            // earlier snapshots belong to the last session
+            memset(_snapshots, 0, sizeof(_snapshots));
+            _ack_seq = 0;
+        }
+        confirm(seq, snapshot);
+        return true;
+    }
+
+    // helper functions
+    const int8_t* Decoder::find(uint8_t seq) const {
+        for (uint8_t i = 0; i < history; ++i) {
+            if (_snapshots[i].seq == seq) return _snapshots[i].values;
+        }
+        return nullptr;
+    }
+
+    void Decoder::confirm(uint8_t seq, const int8_t* snapshot) {
+        Snapshot& s = _snapshots[_next];
+        s.seq = seq;
+        memcpy(s.values, snapshot, sizeof(s.values));
+        _next = (_next + 1 < history) ? _next + 1 : 0;
+
+        // one bit per earlier seq, bit 0 is the previous ack_seq
+        uint8_t d = _ack_seq ? seq_distance(seq, _ack_seq) : 0;
+        if (d == 0 || d >= 128 || d > 8) _ack_bits = 0;
+        else _ack_bits = (_ack_bits << d) | (1U << (d - 1));
+        _ack_seq = seq;
+    }
+
+    bool delta_fits(int8_t val, int8_t base) {
+        int16_t d = static_cast<int16_t>(val) - base;
+        return d >= -8 && d <= 7;
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * @file Downlink.h
+ *
+ * @brief Telemetry multiplexing in the ack payloads, the vehicle
+ *        schedules channels into each payload and the transmitter
+ *        decodes them
+ *
+ * @author Gustavo Monardez
+ *
+ * Payload (AckPackage::telemetry, up to 28 bytes):
+ *
+ *   seq    1..255, 0 is never used
+ *   base   seq of the snapshot the deltas refer to, 0 for none
+ *   runs   up to 4 consecutive channels each, until the end:
+ *            header  bit 7    0 absolute, 1 delta
+ *                    bit 6-5  channels in the run - 1
+ *                    bit 4-0  first channel
+ *            absolute  one byte per channel
+ *            delta     one signed nibble per channel (-8..7), low
+ *                      nibble first, against the base snapshot
+ *
+ * The snapshot of a payload is its base snapshot (all zero without a
+ * base) with the channels of the payload applied. The transmitter keeps
+ * the snapshots of the last payloads it decoded and reports the newest
+ * one in every frame (DataPackage::ack_seq), with a bit per earlier seq
+ * it got (DataPackage::ack_bits). The vehicle only takes a reported seq
+ * as its base, so both sides always hold the base snapshot, and it sends
+ * again the channels of payloads that were reported missing.
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace Downlink {
+    // channel ids on the air, the first ones are Telemetry::Channel
+    const uint8_t channel_count = 16;
+
+    // payload header, seq and base
+    const uint8_t header_size = 2;
+
+    // longest run of channels behind one run header
+    const uint8_t max_run = 4;
+
+    // seq space skips 0, which stands for none
+    uint8_t next_seq(uint8_t seq);
+
+    // seqs from seq back to older, 1..254, 0 when equal, >= 128 means
+    // older is actually newer
+    uint8_t seq_distance(uint8_t seq, uint8_t older);
+
+    /*********************************************************************
+    * @brief             - vehicle side, picks the channels of every
+    *                      payload
+    *
+    * @Note              - channels with a period of 1 go in every
+    *                      payload, the others once every period frames,
+    *                      round robin while the payload has room
+    *********************************************************************/
+    class Scheduler {
+    public:
+        // payloads kept to find the base an ack refers to
+        static const uint8_t history = 4;
+
+        // default period of a channel, in payloads
+        static const uint8_t slow_period = 16;
+
+        Scheduler();
+
+        /********* settings api *********/
+        uint8_t period(uint8_t channel) const;
+        void period(uint8_t channel, uint8_t payloads);
+
+        // latest reading, a channel is sent once it has a value
+        int8_t value(uint8_t channel) const;
+        void value(uint8_t channel, int8_t val);
+
+        /********* counters api *********/
+        uint16_t payloads() const;
+        uint16_t keys() const;
+        uint16_t resent() const;
+
+        // utility functions
+        void acked(uint8_t ack_seq, uint8_t ack_bits);
+        uint8_t encode(uint8_t* out, uint8_t size);
+    private:
+        struct Sent {
+            uint8_t seq;
+            bool checked;
+            uint16_t channels;
+            int8_t snapshot[channel_count];
+        };
+
+        uint8_t pack(uint16_t channels, const int8_t* base, uint8_t* out, uint8_t size) const;
+        bool fits(uint16_t channels, const int8_t* base, uint8_t size) const;
+
+        // channels
+        int8_t _values[channel_count];
+        uint8_t _period[channel_count];
+        uint8_t _age[channel_count];
+        uint16_t _used;
+        uint16_t _lost;
+        uint8_t _next_slow;
+
+        // payloads sent, newest base the transmitter reported
+        Sent _sent[history];
+        uint8_t _next_sent;
+        int8_t _base;
+        uint8_t _seq;
+        uint8_t _stale_ack;
+
+        // counters
+        uint16_t _payloads;
+        uint16_t _keys;
+        uint16_t _resent;
+    };
+
+    /*********************************************************************
+    * @brief             - transmitter side, one per vehicle
+    *
+    * @Note              - values only move forward with the channels a
+    *                      payload carries, a payload whose base is gone
+    *                      still delivers its absolute channels
+    *********************************************************************/
+    class Decoder {
+    public:
+        // snapshots kept, the vehicle's base is the newest ack_seq it
+        // got, at most one more payload is confirmed before a payload
+        // built on it arrives
+        static const uint8_t history = 2;
+
+        Decoder();
+        void clear();
+
+        // latest value of every channel
+        int8_t* values();
+
+        // what goes back in the next frame
+        uint8_t ack_seq() const;
+        uint8_t ack_bits() const;
+
+        /********* counters api *********/
+        uint16_t incomplete() const;
+        uint16_t invalid() const;
+
+        // utility functions
+        bool decode(const uint8_t* buf, uint8_t len);
+    private:
+        struct Snapshot {
+            uint8_t seq;
+            int8_t values[channel_count];
+        };
+
+        const int8_t* find(uint8_t seq) const;
+        void confirm(uint8_t seq, const int8_t* snapshot);
+
+        int8_t _values[channel_count];
+        Snapshot _snapshots[history];
+        uint8_t _next;
+        uint8_t _ack_seq;
+        uint8_t _ack_bits;
+
+        // counters
+        uint16_t _incomplete;
+        uint16_t _invalid;
+    };
+}
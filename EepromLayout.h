@@ -0,0 +1,48 @@
+/**
+ * @file EepromLayout.h
+ *
+ * @brief EEPROM addresses used by persistent settings, and the write
+ *        they all go through
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <EEPROM.h>
+#include "Deadline.h"
+
+namespace EepromLayout {
+    // paired vehicles (see Fleet.cpp)
+    const uint16_t fleet_addr   = 0;
+    const uint16_t fleet_size   = 48;
+
+    // tuning profile, written round robin over its slots (see Tuning.cpp)
+    const uint16_t tuning_addr  = fleet_addr + fleet_size;
+    const uint16_t tuning_size  = 80;
+
+    /*********************************************************************
+    * @fn                - put
+    *
+    * @brief             - EEPROM.put, one byte at a time
+    *
+    * @param[in]         - eeprom address
+    * @param[in]         - value to store
+    *
+    * @return            - none
+    *
+    * @Note              - only changed bytes are written, ~3.3ms each,
+    *                      the deadline is polled after every one so a
+    *                      save never holds the frames back
+    *********************************************************************/
+    template <class T>
+    void put(uint16_t addr, const T& val) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&val);
+        for (uint16_t i = 0; i < sizeof(T); ++i) {
+            if (EEPROM.read(addr + i) == p[i]) continue;
+            EEPROM.write(addr + i, p[i]);
+            Deadline::poll();
+        }
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ * @file Events.cpp
+ *
+ * @brief Ui event queues definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Events.h"
+#include "SpscQueue.h"
+#include <util/atomic.h>
+
+namespace Events {
+    SpscQueue<Event, 16> _turns;
+    SpscQueue<Event, 4> _presses;
+    SpscQueue<Event, 4> _refreshes;
+
+    // shared by every producer
+    volatile uint16_t _dropped = 0;
+
+    // helper functions prototypes
+    template <uint8_t Size>
+    void post(SpscQueue<Event, Size>& q, Type type, int8_t arg);
+
+    void post_turn(int8_t steps) {
+        post(_turns, Type::TURN, steps);
+    }
+
+    void post_press() {
+        post(_presses, Type::PRESS, 0);
+    }
+
+    void post_refresh() {
+        post(_refreshes, Type::REFRESH, 0);
+    }
+
+    /*********************************************************************
+    * @fn                - next
+    *
+    * @brief             - takes the next event
+    *
+    * @param[out]        - event
+    *
+    * @return            - false when nothing happened
+    *
+    * @Note              - turns are consumed before a press so the press
+    *                      applies to the item the knob ended up on
+    *********************************************************************/
+    bool next(Event& ev) {
+        return _turns.pop(ev) || _presses.pop(ev) || _refreshes.pop(ev);
+    }
+
+    uint16_t dropped() {
+        uint16_t val;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            val = _dropped;
+        }
+        return val;
+    }
+
+    // helper functions
+    template <uint8_t Size>
+    void post(SpscQueue<Event, Size>& q, Type type, int8_t arg) {
+        Event ev = { type, arg };
+        if (q.push(ev)) return;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            ++_dropped;
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * @file Events.h
+ *
+ * @brief Ui events posted by the encoder, the button debouncer and
+ *        the telemetry receiver, one queue per producer
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace Events {
+    enum class Type : uint8_t {
+        TURN,       // knob turned, arg holds the steps
+        PRESS,      // knob button pressed (debounced)
+        REFRESH     // telemetry changed, or the first page is due
+    };
+
+    struct Event {
+        Type type;
+        int8_t arg;
+    };
+
+    // producers, each one owns its queue
+    void post_turn(int8_t steps);   // encoder isr
+    void post_press();              // pin change isr
+    void post_refresh();            // main loop
+
+    // consumer, main loop only
+    bool next(Event& ev);
+
+    // events lost because a queue was full
+    uint16_t dropped();
+}
@@ -0,0 +1,64 @@
+/**
+ * @file Fixed.h
+ *
+ * @brief Fixed-point helpers, so sensor conversions never touch the
+ *        software float library
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+/*
+* A Q<frac> value stores x * 2^frac in a plain integer. Constants are
+* built at compile time with Fixed::q(), a division by a constant
+* becomes a multiply by its Q reciprocal followed by a shift.
+*/
+namespace Fixed {
+    // round(num / den * 2^frac), meant for compile-time constants
+    constexpr int32_t q(int32_t num, int32_t den, uint8_t frac) {
+        return static_cast<int32_t>(((static_cast<int64_t>(num) << frac) + den / 2) / den);
+    }
+
+    // ceil(num * 2^frac / den), multiplying by it never falls short
+    // of the exact quotient, num << frac must fit in 32 bits since it
+    // is also used at runtime
+    constexpr uint32_t reciprocal(uint32_t num, uint32_t den, uint8_t frac) {
+        return ((num << frac) + den - 1) / den;
+    }
+
+    // drops frac bits, rounding to nearest
+    template <uint8_t Frac>
+    inline int32_t round_shift(int32_t val) {
+        return (val + (1L << (Frac - 1))) >> Frac;
+    }
+
+    /****************************** saturation ******************************/
+    template <typename T> T saturate(int32_t val);
+
+    template <> inline int8_t saturate<int8_t>(int32_t val) {
+        return (val < -128) ? -128 : (val > 127) ? 127 : val;
+    }
+
+    template <> inline uint8_t saturate<uint8_t>(int32_t val) {
+        return (val < 0) ? 0 : (val > 255) ? 255 : val;
+    }
+
+    template <> inline int16_t saturate<int16_t>(int32_t val) {
+        return (val < -32768) ? -32768 : (val > 32767) ? 32767 : val;
+    }
+
+    /*
+    * y = x * gain + offset, gain and offset in Q<Frac>. Everything is
+    * a template argument, so the constants live in the instructions
+    * and not in ram.
+    */
+    template <int32_t Gain, int32_t Offset, uint8_t Frac>
+    struct Linear {
+        static int32_t apply(int16_t x) {
+            return round_shift<Frac>(static_cast<int32_t>(x) * Gain + Offset);
+        }
+    };
+}
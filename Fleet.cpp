@@ -0,0 +1,314 @@
+/**
+ * @file Fleet.cpp
+ *
+ * @brief Paired vehicles, active vehicle selection and
+ *        time-slotted transmit schedule definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Fleet.h"
+#include "EepromLayout.h"
+#include "Latency.h"
+#include "RetryPolicy.h"
+#include "RadioTx.h"
+#include "Arduino.h"
+#include <EEPROM.h>
+
+namespace Fleet {
+    // record stored in eeprom, bump the magic when the layout changes
+    const uint8_t eeprom_magic = 0xF1;
+    struct Record {
+        uint8_t magic;
+        uint8_t count;
+        uint8_t active;
+        uint8_t schedule;
+        uint64_t addr[max_vehicles];
+    };
+    static_assert(sizeof(Record) <= EepromLayout::fleet_size,
+                  "fleet record does not fit its eeprom area");
+
+    // paired vehicles
+    uint64_t _base_addr = 0;
+    uint64_t _addr[max_vehicles];
+    uint8_t _count = 0;
+
+    // schedule
+    uint8_t _active = 0;
+    Schedule _schedule = Schedule::SINGLE;
+    uint16_t _slot_period_us = 5000;
+    uint8_t _slot = 0;
+    unsigned long _last_slot_us = 0;
+    int8_t _open_idx = -1;
+
+    // pairing, 0 when idle, otherwise next probe offset + 1
+    uint8_t _probe = 0;
+    bool _save_pending = false;
+
+    // telemetry channels of each vehicle, decoded from the ack payloads
+    Downlink::Decoder _downlink[max_vehicles];
+
+    // helper functions prototypes
+    bool is_paired(uint64_t addr);
+    void probe_next(RF24& radio);
+
+    /*********************************************************************
+    * @fn                - load
+    *
+    * @brief             - restores the paired vehicles from eeprom
+    *
+    * @param[in]         - base address, used as the only vehicle when
+    *                      nothing has been paired yet
+    *
+    * @return            - none
+    *
+    * @Note              - none
+    *********************************************************************/
+    void load(uint64_t base_addr) {
+        _base_addr = base_addr;
+
+        Record rec;
+        EEPROM.get(EepromLayout::fleet_addr, rec);
+        if (rec.magic != eeprom_magic || rec.count == 0 || rec.count > max_vehicles) {
+            _addr[0] = base_addr;
+            _count = 1;
+            _active = 0;
+            _schedule = Schedule::SINGLE;
+            return;
+        }
+        memcpy(_addr, rec.addr, sizeof(_addr));
+        _count = rec.count;
+        _active = (rec.active < rec.count) ? rec.active : 0;
+        _schedule = static_cast<Schedule>(rec.schedule);
+    }
+
+    /*********************************************************************
+    * @fn                - save
+    *
+    * @brief             - stores the paired vehicles in eeprom
+    *
+    * @param[in]         - none
+    *
+    * @return            - none
+    *
+    * @Note              - only the bytes that changed are written
+    *********************************************************************/
+    void save() {
+        Record rec;
+        rec.magic = eeprom_magic;
+        rec.count = _count;
+        rec.active = _active;
+        rec.schedule = static_cast<uint8_t>(_schedule);
+        memcpy(rec.addr, _addr, sizeof(rec.addr));
+        EepromLayout::put(EepromLayout::fleet_addr, rec);
+    }
+
+    /********* pairing api *********/
+    uint8_t count() {
+        return _count;
+    }
+
+    uint64_t address(uint8_t idx) {
+        return _addr[idx];
+    }
+
+    void request_pair() {
+        if (_probe == 0) _probe = 1;
+    }
+
+    bool pairing() {
+        return _probe != 0;
+    }
+
+    /********* schedule api *********/
+    uint8_t active() {
+        return _active;
+    }
+
+    void active(uint8_t idx) {
+        if (idx < _count) _active = idx;
+    }
+
+    Schedule schedule() {
+        return _schedule;
+    }
+
+    void schedule(Schedule val) {
+        _schedule = val;
+        _slot = 0;
+    }
+
+    uint16_t slot_period_us() {
+        return _slot_period_us;
+    }
+
+    void slot_period_us(uint16_t val) {
+        _slot_period_us = val;
+    }
+
+    /********* telemetry api *********/
+    int8_t* telemetry(uint8_t idx) {
+        return _downlink[idx].values();
+    }
+
+    const Downlink::Decoder& downlink(uint8_t idx) {
+        return _downlink[idx];
+    }
+
+    /*********************************************************************
+    * @fn                - service
+    *
+    * @brief             - runs pending radio work that is not part of
+    *                      the regular schedule (pairing)
+    *
+    * @param[in]         - reference to radio object (RF24)
+    *
+    * @return            - none
+    *
+    * @Note              - a single address is probed per call, the
+    *                      probe is queued like any frame so the control
+    *                      loop keeps running while pairing. Call while
+    *                      the radio is idle, the previous probe is done
+    *********************************************************************/
+    void service(RF24& radio) {
+        if (_save_pending) {
+            _save_pending = false;
+            save();
+        }
+        if (_probe != 0) probe_next(radio);
+    }
+
+    /*********************************************************************
+    * @fn                - next_slot
+    *
+    * @brief             - picks the vehicle the next frame goes to
+    *
+    * @param[in]         - none
+    *
+    * @return            - vehicle index, -1 if no frame is due yet
+    *
+    * @Note              - in slotted mode every vehicle gets one frame
+    *                      per round, so its update rate is bounded by
+    *                      1 / (slot period * vehicle count)
+    *********************************************************************/
+    int8_t next_slot() {
+        uint8_t idx = _active;
+
+        if (_schedule == Schedule::SLOTTED) {
+            unsigned long now = micros();
+            if (now - _last_slot_us < _slot_period_us) return -1;
+            _last_slot_us = now;
+
+            idx = _slot;
+            _slot = (_slot + 1 < _count) ? _slot + 1 : 0;
+        }
+        return idx;
+    }
+
+    /*********************************************************************
+    * @fn                - open_slot
+    *
+    * @brief             - points the writing pipe at a vehicle
+    *
+    * @param[in]         - reference to radio object (RF24)
+    * @param[in]         - vehicle index, count() for the address being
+    *                      probed
+    *
+    * @return            - none
+    *
+    * @Note              - the tx fifo must be empty, a queued frame
+    *                      would go out to the new address
+    *********************************************************************/
+    void open_slot(RF24& radio, uint8_t idx) {
+        // only touch the radio registers when the target changes
+        if (idx != _open_idx) {
+            radio.openWritingPipe(_addr[idx]);
+            _open_idx = idx;
+        }
+    }
+
+    /*********************************************************************
+    * @fn                - store_ack
+    *
+    * @brief             - decodes the ack payload of the last frame into
+    *                      the telemetry channels of its vehicle and feeds
+    *                      its echoed stamp to the latency stats
+    *
+    * @param[in]         - reference to radio object (RF24)
+    * @param[in]         - vehicle index the frame was sent to
+    * @param[in]         - stamp of the irq that reported the ack
+    * @param[in]         - false if the ack was found without an irq,
+    *                      its time is unknown and no round trip is taken
+    *
+    * @return            - none
+    *
+    * @Note              - an ack for the free slot means the probed
+    *                      address answered, it is paired and its ack
+    *                      payload is its first telemetry. Saved from
+    *                      service(), not from inside the tx path
+    *********************************************************************/
+    void store_ack(RF24& radio, uint8_t idx, uint16_t ack_stamp, bool timed) {
+        if (idx == _count && _probe != 0) {
+            _active = _count++;
+            _probe = 0;
+            _save_pending = true;
+        }
+
+        while (radio.isAckPayloadAvailable()) {
+            uint8_t len = radio.getDynamicPayloadSize();
+            if (len < ack_header_size || len > sizeof(AckPackage)) {
+                // corrupt payload size, drop whatever is in the fifo
+                radio.flush_rx();
+                return;
+            }
+
+            AckPackage ack;
+            radio.read(&ack, len);
+            if (timed) Latency::ack(ack.echo_stamp, ack.hold, ack_stamp);
+            _downlink[idx].decode(reinterpret_cast<const uint8_t*>(ack.telemetry),
+                                  len - ack_header_size);
+        }
+    }
+
+    void print() {
+        const Downlink::Decoder& d = _downlink[_active];
+        Serial.print(F("fleet: count="));       Serial.print(_count);
+        Serial.print(F(" active="));            Serial.print(_active);
+        Serial.print(F(" downlink ack="));      Serial.print(d.ack_seq());
+        Serial.print(F(" bits="));              Serial.print(d.ack_bits(), BIN);
+        Serial.print(F(" incomplete="));        Serial.print(d.incomplete());
+        Serial.print(F(" invalid="));           Serial.println(d.invalid());
+    }
+
+    // helper functions
+    bool is_paired(uint64_t addr) {
+        for (uint8_t i = 0; i < _count; ++i) {
+            if (_addr[i] == addr) return true;
+        }
+        return false;
+    }
+
+    void probe_next(RF24& radio) {
+        if (_count >= max_vehicles || _probe > max_probe) {
+            _probe = 0;
+            return;
+        }
+
+        uint64_t candidate = _base_addr + _probe;
+        ++_probe;
+        if (is_paired(candidate)) return;
+
+        // the free slot holds the candidate while the probe is in
+        // flight, store_ack pairs it if it answers
+        _addr[_count] = candidate;
+        _downlink[_count].clear();
+        _open_idx = -1;
+
+        // a neutral frame is harmless for any vehicle that answers
+        DataPackage neutral;
+        memset(&neutral, 0, sizeof(neutral));
+        uint8_t frame[max_frame_len];
+        uint8_t len = pack_frame(neutral, frame);
+        if (!RadioTx::send(radio, _count, frame, len, RetryPolicy::Traffic::PROBE)) --_probe;
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * @file Fleet.h
+ *
+ * @brief Paired vehicles, active vehicle selection and
+ *        time-slotted transmit schedule
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <RF24.h>
+#include "DataPackage.h"
+#include "Downlink.h"
+
+namespace Fleet {
+    const uint8_t max_vehicles      = 4;
+
+    // addresses probed while pairing: base address + 1..max_probe
+    const uint8_t max_probe         = 16;
+
+    enum class Schedule : uint8_t {
+        SINGLE,     // every frame goes to the active vehicle
+        SLOTTED     // frames rotate over all paired vehicles
+    };
+
+    /********* pairing api *********/
+    void load(uint64_t base_addr);
+    void save();
+    uint8_t count();
+    uint64_t address(uint8_t idx);
+    void request_pair();
+    bool pairing();
+
+    /********* schedule api *********/
+    uint8_t active();
+    void active(uint8_t idx);
+    Schedule schedule();
+    void schedule(Schedule val);
+    uint16_t slot_period_us();
+    void slot_period_us(uint16_t val);
+
+    /********* telemetry api *********/
+    int8_t* telemetry(uint8_t idx);
+    const Downlink::Decoder& downlink(uint8_t idx);
+
+    // radio side, called from the main loop
+    void service(RF24& radio);
+    int8_t next_slot();
+    void open_slot(RF24& radio, uint8_t idx);
+    void store_ack(RF24& radio, uint8_t idx, uint16_t ack_stamp, bool timed);
+
+    void print();
+}
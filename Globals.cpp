@@ -0,0 +1,20 @@
+/**
+ * @file Globals.cpp
+ *
+ * @brief Global variables definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Globals.h"
+
+namespace Globals {
+	// transmitter
+	RF24 transmitter(Board::RadioCe::number, Board::RadioCsn::number);
+
+	// display unit
+	LiquidCrystal_I2C lcd(0x27, 16, 2);
+
+	// outgoing data
+	DataPackage data_pkg;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file GlyphCache.cpp
+ *
+ * @brief Lcd glyph cache definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "GlyphCache.h"
+#include "LcdCustomCharacters.h"
+
+namespace GlyphCache {
+    const uint8_t none = 0xFF;
+
+    // glyph held by each slot and slot held by each glyph
+    uint8_t _slot_glyph[slots];
+    uint8_t _glyph_slot[GLYPH_COUNT];
+
+    // last use of each slot, the smallest one is evicted
+    uint16_t _slot_used[slots];
+    uint16_t _clock = 0;
+
+    // one bit per glyph id
+    uint16_t _pinned = 0;
+    uint16_t _stale = 0;
+
+    // runtime bitmaps of the dynamic glyphs
+    uint8_t _dynamic[GLYPH_COUNT - dynamic_glyphs][8];
+
+    uint16_t _uploads = 0;
+
+    // helper functions prototypes
+    uint8_t victim();
+    void upload(LiquidCrystal_I2C& lcd, uint8_t slot, uint8_t id);
+
+    void reset() {
+        memset(_slot_glyph, none, sizeof(_slot_glyph));
+        memset(_glyph_slot, none, sizeof(_glyph_slot));
+        memset(_slot_used, 0, sizeof(_slot_used));
+        _stale = 0;
+    }
+
+    void pin_none() {
+        _pinned = 0;
+    }
+
+    void pin(uint8_t id) {
+        _pinned |= 1 << id;
+    }
+
+    void define(uint8_t id, const uint8_t bitmap[8]) {
+        uint8_t* dst = _dynamic[id - dynamic_glyphs];
+        if (memcmp(dst, bitmap, 8) == 0) return;
+        memcpy(dst, bitmap, 8);
+        if (_glyph_slot[id] != none) _stale |= 1 << id;
+    }
+
+    /*********************************************************************
+    * @fn                - acquire
+    *
+    * @brief             - finds the cgram slot of a glyph
+    *
+    * @param[in]         - reference to lcd object
+    * @param[in]         - glyph id (Symbols)
+    *
+    * @return            - cgram slot, usable as a character code
+    *
+    * @Note              - resident glyphs cost no bus traffic, an upload
+    *                      leaves the lcd addressing cgram so the caller
+    *                      must set the cursor before writing text
+    *********************************************************************/
+    uint8_t acquire(LiquidCrystal_I2C& lcd, uint8_t id) {
+        uint8_t slot = _glyph_slot[id];
+        if (slot == none) {
+            slot = victim();
+            if (_slot_glyph[slot] != none) _glyph_slot[_slot_glyph[slot]] = none;
+            _slot_glyph[slot] = id;
+            _glyph_slot[id] = slot;
+            upload(lcd, slot, id);
+        }
+        _slot_used[slot] = ++_clock;
+        return slot;
+    }
+
+    bool stale() {
+        return _stale != 0;
+    }
+
+    bool refresh(LiquidCrystal_I2C& lcd) {
+        if (_stale == 0) return false;
+
+        uint8_t id = 0;
+        while (!(_stale & (1 << id))) ++id;
+        upload(lcd, _glyph_slot[id], id);
+        return true;
+    }
+
+    uint16_t uploads() {
+        return _uploads;
+    }
+
+    void print() {
+        Serial.print(F("glyphs: uploads="));
+        Serial.print(_uploads);
+        Serial.print(F(" slots="));
+        for (uint8_t s = 0; s < slots; ++s) {
+            if (s > 0) Serial.print(',');
+            if (_slot_glyph[s] == none) Serial.print('-');
+            else Serial.print(_slot_glyph[s]);
+        }
+        Serial.println();
+    }
+
+    // helper functions
+    uint8_t victim() {
+        uint8_t lru = none;
+        uint8_t lru_any = 0;
+        for (uint8_t s = 0; s < slots; ++s) {
+            uint8_t id = _slot_glyph[s];
+            if (id == none) return s;
+
+            // with the clock wrapping, age is what gets compared
+            uint16_t age = _clock - _slot_used[s];
+            if (age > static_cast<uint16_t>(_clock - _slot_used[lru_any])) lru_any = s;
+            if (!(_pinned & (1 << id))
+                && (lru == none || age > static_cast<uint16_t>(_clock - _slot_used[lru]))) {
+                lru = s;
+            }
+        }
+        // a page with more than 8 glyphs has to give one up
+        return (lru != none) ? lru : lru_any;
+    }
+
+    void upload(LiquidCrystal_I2C& lcd, uint8_t slot, uint8_t id) {
+        if (id < dynamic_glyphs) {
+            load_custom_char(lcd, slot,
+                static_cast<const uint8_t*>(pgm_read_ptr(&glyph_bitmaps[id])));
+        } else {
+            lcd.createChar(slot, _dynamic[id - dynamic_glyphs]);
+        }
+        _stale &= ~(1 << id);
+        ++_uploads;
+    }
+}
@@ -0,0 +1,40 @@
+/**
+ * @file GlyphCache.h
+ *
+ * @brief Maps logical glyph ids to the 8 lcd cgram slots, uploading
+ *        glyphs on demand and evicting the least recently used one
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <LiquidCrystal_I2C.h>
+
+namespace GlyphCache {
+    const uint8_t slots = 8;
+
+    // forgets every resident glyph, i.e. after lcd.init
+    void reset();
+
+    // glyphs on the current page are never evicted while
+    // another slot can be used
+    void pin_none();
+    void pin(uint8_t id);
+
+    // sets the bitmap of a dynamic glyph, a resident copy
+    // is refreshed on the next flush if it changed
+    void define(uint8_t id, const uint8_t bitmap[8]);
+
+    // cgram slot holding the glyph, uploaded first if needed
+    uint8_t acquire(LiquidCrystal_I2C& lcd, uint8_t id);
+
+    // re-uploads one resident dynamic glyph that changed
+    bool stale();
+    bool refresh(LiquidCrystal_I2C& lcd);
+
+    // number of cgram uploads so far
+    uint16_t uploads();
+    void print();
+}
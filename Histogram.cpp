@@ -0,0 +1,121 @@
+/**
+ * @file Histogram.cpp
+ *
+ * @brief Rolling log2 histogram definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "Histogram.h"
+
+/*********************************************************************
+* @fn                - Histogram::add
+*
+* @brief             - adds a sample to its bucket
+*
+* @param[in]         - sample in microseconds
+*
+* @return            - none
+*
+* @Note              - bucket selection is a shift loop, no division
+*********************************************************************/
+void Histogram::add(uint32_t val_us) {
+    uint8_t bucket = 0;
+    uint32_t bound = 64;
+    while (bucket < buckets - 1 && val_us >= bound) {
+        ++bucket;
+        bound <<= 1;
+    }
+
+    if (_total >= window) {
+        _total = 0;
+        for (uint8_t i = 0; i < buckets; ++i) {
+            _counts[i] >>= 1;
+            _total += _counts[i];
+        }
+    }
+    ++_counts[bucket];
+    ++_total;
+
+    if (_total == 1 || val_us < _min_us) _min_us = val_us;
+    if (val_us > _max_us) _max_us = val_us;
+    _last_us = val_us;
+}
+
+void Histogram::clear() {
+    memset(this, 0, sizeof(*this));
+}
+
+uint16_t Histogram::count(uint8_t bucket) const {
+    return _counts[bucket];
+}
+
+uint16_t Histogram::total() const {
+    return _total;
+}
+
+uint32_t Histogram::min_us() const {
+    return _min_us;
+}
+
+uint32_t Histogram::max_us() const {
+    return _max_us;
+}
+
+uint32_t Histogram::last_us() const {
+    return _last_us;
+}
+
+uint32_t Histogram::upper_bound_us(uint8_t bucket) {
+    return 64UL << bucket;
+}
+
+/*********************************************************************
+* @fn                - Histogram::percentile_us
+*
+* @brief             - estimates a percentile from the buckets
+*
+* @param[in]         - percentile (0-100)
+*
+* @return            - upper bound of the bucket holding it
+*
+* @Note              - resolution is one bucket (a factor of 2)
+*********************************************************************/
+uint32_t Histogram::percentile_us(uint8_t pct) const {
+    uint32_t target = (static_cast<uint32_t>(_total) * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < buckets; ++i) {
+        seen += _counts[i];
+        if (seen >= target && seen > 0) return upper_bound_us(i);
+    }
+    return 0;
+}
+
+/*********************************************************************
+* @fn                - Histogram::print
+*
+* @brief             - dumps the histogram over serial
+*
+* @param[in]         - name printed in front of the figures
+*
+* @return            - none
+*
+* @Note              - none
+*********************************************************************/
+void Histogram::print(const __FlashStringHelper* name) const {
+    Serial.print(name);
+    Serial.print(F(": n="));    Serial.print(_total);
+    Serial.print(F(" last="));  Serial.print(_last_us);
+    Serial.print(F(" min="));   Serial.print(_min_us);
+    Serial.print(F(" max="));   Serial.print(_max_us);
+    Serial.print(F(" p50<"));   Serial.print(percentile_us(50));
+    Serial.print(F(" p90<"));   Serial.print(percentile_us(90));
+    Serial.print(F(" p99<"));   Serial.println(percentile_us(99));
+    Serial.print(F("    "));
+    for (uint8_t i = 0; i < buckets; ++i) {
+        Serial.print(_counts[i]);
+        Serial.print(' ');
+    }
+    Serial.println();
+}
@@ -0,0 +1,44 @@
+/**
+ * @file Histogram.h
+ *
+ * @brief Rolling log2 histogram for timing measurements
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+class __FlashStringHelper;
+
+class Histogram {
+public:
+    // bucket 0 holds values below 64us, every next bucket doubles the
+    // upper bound, the last one holds everything above 65ms
+    static const uint8_t buckets = 12;
+
+    void add(uint32_t val_us);
+    void clear();
+
+    uint16_t count(uint8_t bucket) const;
+    uint16_t total() const;
+    uint32_t min_us() const;
+    uint32_t max_us() const;
+    uint32_t last_us() const;
+    uint32_t percentile_us(uint8_t pct) const;
+
+    static uint32_t upper_bound_us(uint8_t bucket);
+
+    void print(const __FlashStringHelper* name) const;
+private:
+    // counts are halved once the total reaches this value, so old
+    // samples fade out and the histogram follows recent behaviour
+    static const uint16_t window = 1024;
+
+    uint16_t _counts[buckets];
+    uint16_t _total;
+    uint32_t _min_us;
+    uint32_t _max_us;
+    uint32_t _last_us;
+};
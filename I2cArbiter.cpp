@@ -0,0 +1,175 @@
+/**
+ * @file I2cArbiter.cpp
+ *
+ * @brief Prioritized access to the i2c bus definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "I2cArbiter.h"
+#include "Display.h"
+#include "Trace.h"
+#include <Wire.h>
+
+namespace I2cArbiter {
+    // the mpu-6050 supports fast mode, the pcf8574 lcd backpack
+    // is only rated for standard mode
+    const uint32_t imu_clock_hz = 400000;
+    const uint32_t lcd_clock_hz = 100000;
+
+    // settings
+    uint16_t _imu_period_us = 5000;
+    uint16_t _lcd_slice_us = 2000;
+
+    // state
+    void (*_imu_job)() = nullptr;
+    Client _clock_owner = Client::LCD;
+    unsigned long _transaction_start_us = 0;
+    unsigned long _last_imu_us = 0;
+    unsigned long _window_start_us = 0;
+
+    // usage per client
+    struct Usage {
+        uint32_t transactions;
+        uint32_t busy_us;
+    };
+    Usage _usage[2];
+
+    /********* settings api *********/
+    uint16_t imu_period_us() {
+        return _imu_period_us;
+    }
+
+    uint16_t lcd_slice_us() {
+        return _lcd_slice_us;
+    }
+
+    void imu_period_us(uint16_t val) {
+        _imu_period_us = val;
+    }
+
+    void lcd_slice_us(uint16_t val) {
+        _lcd_slice_us = val;
+    }
+
+    /*********************************************************************
+    * @fn                - config_bus
+    *
+    * @brief             - registers the imu sampling job
+    *
+    * @param[in]         - function that reads the imu, nullptr until
+    *                      the imu is calibrated
+    *
+    * @return            - none
+    *
+    * @Note              - call after the mpu-6050 was woken up, it
+    *                      resets the bus clock. The lcd init resets it
+    *                      too, it runs as an LCD transaction
+    *********************************************************************/
+    void config_bus(void (*imu_job)()) {
+        _imu_job = imu_job;
+        _clock_owner = Client::LCD;
+        Wire.setClock(lcd_clock_hz);
+        _window_start_us = micros();
+
+        Serial.println(F("    I2C arbiter config complete!"));
+    }
+
+    void imu_job(void (*job)()) {
+        _imu_job = job;
+    }
+
+    /*********************************************************************
+    * @fn                - begin / end
+    *
+    * @brief             - wrap every transaction, switching the bus
+    *                      clock to what the client supports and
+    *                      accounting for the time it holds the bus
+    *
+    * @param[in]         - client about to use / done using the bus
+    *
+    * @return            - none
+    *
+    * @Note              - none
+    *********************************************************************/
+    void begin(Client client) {
+        if (client != _clock_owner) {
+            Wire.setClock(client == Client::IMU ? imu_clock_hz : lcd_clock_hz);
+            _clock_owner = client;
+        }
+        _transaction_start_us = micros();
+        Trace::record(Trace::Event::I2C_BEGIN, static_cast<uint8_t>(client));
+    }
+
+    void end(Client client) {
+        Usage& usage = _usage[static_cast<uint8_t>(client)];
+        ++usage.transactions;
+        usage.busy_us += micros() - _transaction_start_us;
+        Trace::record(Trace::Event::I2C_END, static_cast<uint8_t>(client));
+    }
+
+    /*********************************************************************
+    * @fn                - run_imu
+    *
+    * @brief             - runs the imu job now
+    *
+    * @param[in]         - none
+    *
+    * @return            - none
+    *
+    * @Note              - none
+    *********************************************************************/
+    void run_imu() {
+        if (_imu_job == nullptr) return;
+        begin(Client::IMU);
+        _imu_job();
+        end(Client::IMU);
+        _last_imu_us = micros();
+    }
+
+    /*********************************************************************
+    * @fn                - run_lcd
+    *
+    * @brief             - flushes pending display changes for at most
+    *                      one lcd slice
+    *
+    * @param[in]         - reference to lcd object
+    *
+    * @return            - none
+    *
+    * @Note              - the imu job preempts the flush between chunks
+    *                      whenever its period elapses, so control inputs
+    *                      never wait behind a page redraw
+    *********************************************************************/
+    void run_lcd(LiquidCrystal_I2C& lcd) {
+        unsigned long slice_start = micros();
+
+        while (Display::dirty()) {
+            if (micros() - _last_imu_us >= _imu_period_us) run_imu();
+            if (micros() - slice_start >= _lcd_slice_us) break;
+
+            begin(Client::LCD);
+            bool wrote = Display::flush_chunk(lcd);
+            end(Client::LCD);
+            if (!wrote) break;
+        }
+    }
+
+    void print() {
+        unsigned long window_us = micros() - _window_start_us;
+        uint32_t busy_us = _usage[0].busy_us + _usage[1].busy_us;
+
+        Serial.print(F("i2c: imu n="));  Serial.print(_usage[0].transactions);
+        Serial.print(F(" busy="));       Serial.print(_usage[0].busy_us);
+        Serial.print(F("us lcd n="));    Serial.print(_usage[1].transactions);
+        Serial.print(F(" busy="));       Serial.print(_usage[1].busy_us);
+        Serial.print(F("us util="));
+        Serial.print(window_us ? busy_us / (window_us / 100 + 1) : 0);
+        Serial.println('%');
+
+        // every dump starts a new window
+        memset(_usage, 0, sizeof(_usage));
+        _window_start_us = micros();
+    }
+}
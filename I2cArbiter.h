@@ -0,0 +1,36 @@
+/**
+ * @file I2cArbiter.h
+ *
+ * @brief Prioritized access to the i2c bus shared by the
+ *        mpu-6050 and the lcd
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <LiquidCrystal_I2C.h>
+
+namespace I2cArbiter {
+    enum class Client : uint8_t {
+        IMU,    // high priority, runs at a fixed period
+        LCD     // low priority, split in small chunks
+    };
+
+    /********* settings api *********/
+    uint16_t imu_period_us();
+    uint16_t lcd_slice_us();
+    void imu_period_us(uint16_t val);
+    void lcd_slice_us(uint16_t val);
+
+    // utility functions
+    void config_bus(void (*imu_job)());
+    void imu_job(void (*job)());
+    void begin(Client client);
+    void end(Client client);
+    void run_imu();
+    void run_lcd(LiquidCrystal_I2C& lcd);
+
+    void print();
+}
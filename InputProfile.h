@@ -0,0 +1,53 @@
+/**
+ * @file InputProfile.h
+ *
+ * @brief Inputs built into the transmitter, picked at compile time
+ *
+ * @author Gustavo Monardez
+ *
+ * Inputs left out of the profile are not sampled, calibrated or sent,
+ * every use is behind a check of has(), which is constant, so the code
+ * is dropped by the compiler. Frames carry the id of their profile, the
+ * vehicle decodes any of them (DataPackage.h, frame_len).
+ */
+#pragma once
+
+#include <stdint.h>
+
+// profile built into the transmitter, one of InputProfile::Id, set it
+// here or pass -DINPUT_PROFILE=n to the compiler
+#ifndef INPUT_PROFILE
+#define INPUT_PROFILE 0
+#endif
+
+namespace InputProfile {
+    // inputs, in the order they follow the frame header
+    const uint8_t J1  = 0x01;
+    const uint8_t J2  = 0x02;
+    const uint8_t IMU = 0x04;
+
+    // ids on the air, new profiles go at the end
+    enum Id : uint8_t {
+        FULL,           // both joysticks and tilt
+        STICKS,         // both joysticks
+        ONE_STICK,      // joystick 1
+        TILT,           // mpu-6050 only
+        PROFILE_COUNT
+    };
+
+    // inputs of a profile, 0 for an unknown id
+    constexpr uint8_t inputs(uint8_t id) {
+        return (id == FULL)      ? J1 | J2 | IMU :
+               (id == STICKS)    ? J1 | J2 :
+               (id == ONE_STICK) ? J1 :
+               (id == TILT)      ? IMU : 0;
+    }
+
+    const uint8_t active = INPUT_PROFILE;
+    static_assert(active < PROFILE_COUNT, "INPUT_PROFILE is not an InputProfile::Id");
+
+    // true if the active profile has the input
+    constexpr bool has(uint8_t input) {
+        return (inputs(active) & input) != 0;
+    }
+}
@@ -16,7 +16,8 @@ struct Joystick {
 	uint8_t down;
 	uint8_t up;
 
+    // adc pins, the switch is read through its Board pin, they are
+    // not sent (pack_frame)
     uint8_t vrx_pin;
     uint8_t vry_pin;
-    uint8_t sw_pin;
 };
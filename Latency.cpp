@@ -0,0 +1,80 @@
+/**
+ * @file Latency.cpp
+ *
+ * @brief Control latency and round trip measurement definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "Latency.h"
+
+namespace Latency {
+    // micros() of the last input sample
+    unsigned long _sampled_us = 0;
+
+    Histogram _sample_to_send;
+    Histogram _round_trip;
+
+    uint16_t stamp() {
+        return static_cast<uint16_t>(micros() >> 2);
+    }
+
+    void sampled(unsigned long sample_us) {
+        _sampled_us = sample_us;
+    }
+
+    void sending() {
+        _sample_to_send.add(micros() - _sampled_us);
+    }
+
+    /*********************************************************************
+    * @fn                - ack
+    *
+    * @brief             - computes a round trip sample from an ack
+    *
+    * @param[in]         - tx_stamp of the previous frame the vehicle got
+    * @param[in]         - vehicle time between that frame and the one
+    *                      being acknowledged, in stamp ticks
+    * @param[in]         - stamp of the irq that reported the ack
+    *
+    * @return            - none
+    *
+    * @Note              - the vehicle preloads its ack payload, so it can
+    *                      only echo the stamp of the frame before. The
+    *                      time it held that stamp is subtracted, which
+    *                      leaves uplink + downlink time (retries included).
+    *                      The loop may service the radio late, so the
+    *                      irq time is used rather than stamp()
+    *********************************************************************/
+    void ack(uint16_t echo_stamp, uint16_t hold, uint16_t ack_stamp) {
+        // hold is 0 when the vehicle has nothing to echo yet
+        if (hold == 0) return;
+
+        uint16_t rtt = ack_stamp - echo_stamp - hold;
+        _round_trip.add(static_cast<uint32_t>(rtt) << 2);
+    }
+
+    /********* results api *********/
+    const Histogram& sample_to_send() {
+        return _sample_to_send;
+    }
+
+    const Histogram& round_trip() {
+        return _round_trip;
+    }
+
+    uint32_t one_way_us() {
+        return _round_trip.percentile_us(50) >> 1;
+    }
+
+    void print() {
+        _sample_to_send.print(F("sample->send us"));
+        _round_trip.print(F("round trip us"));
+        Serial.print(F("one way p50 ~"));
+        Serial.print(one_way_us());
+        Serial.print(F("us, stick->vehicle p50 ~"));
+        Serial.print(_sample_to_send.percentile_us(50) + one_way_us());
+        Serial.println(F("us"));
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * @file Latency.h
+ *
+ * @brief Control latency and round trip measurement
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include "Histogram.h"
+
+namespace Latency {
+    // compact timestamp carried by every frame, 4us per tick,
+    // wraps around every ~262ms
+    uint16_t stamp();
+
+    // called with the micros() at which the inputs of the next frame
+    // were sampled
+    void sampled(unsigned long sample_us);
+
+    // called right before the frame is handed to the radio
+    void sending();
+
+    // called with the header of every ack payload received and the
+    // stamp of the irq that reported it
+    void ack(uint16_t echo_stamp, uint16_t hold, uint16_t ack_stamp);
+
+    /********* results api *********/
+    const Histogram& sample_to_send();
+    const Histogram& round_trip();
+    uint32_t one_way_us();
+
+    void print();
+}
@@ -0,0 +1,129 @@
+/**
+ * @file LcdCustomCharacters.cpp
+ *
+ * @brief Display custom characters bitmaps (flash resident)
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "LcdCustomCharacters.h"
+#include "Arduino.h"
+
+const uint8_t select_arrow[8] PROGMEM = {
+	B00000,
+	B00100,
+	B00110,
+	B11111,
+	B00110,
+	B00100,
+	B00000,
+};
+
+const uint8_t back_arrow[8] PROGMEM = {
+  B00000,
+  B00101,
+  B01101,
+  B11111,
+  B01100,
+  B00100,
+  B00000,
+  B00000
+};
+
+const uint8_t thermometer[8] PROGMEM = {
+  B00100,
+  B01110,
+  B00100,
+  B00100,
+  B00100,
+  B00100,
+  B00100,
+  B00000
+};
+
+const uint8_t battery[8] PROGMEM = {
+  B00110,
+  B01111,
+  B01001,
+  B01111,
+  B01111,
+  B01111,
+  B01111,
+  B00000
+};
+
+const uint8_t dot[8] PROGMEM = {
+  B00000,
+  B00000,
+  B01100,
+  B11110,
+  B11110,
+  B01100,
+  B00000,
+  B00000
+};
+
+const uint8_t percent[8] PROGMEM = {
+  B11000,
+  B11001,
+  B00010,
+  B00100,
+  B01000,
+  B10011,
+  B00011,
+  B00000
+};
+
+const uint8_t sun[8] PROGMEM = {
+  B00100,
+  B10101,
+  B01110,
+  B11011,
+  B01110,
+  B10101,
+  B00100,
+  B00000
+};
+
+const uint8_t blank[8] PROGMEM = {
+  B00000,
+  B00000,
+  B00000,
+  B00000,
+  B00000,
+  B00000,
+  B00000,
+  B00000
+};
+
+// glyph registry, indexed by Symbols
+const uint8_t* const glyph_bitmaps[] PROGMEM = {
+    select_arrow,
+    back_arrow,
+    thermometer,
+    battery,
+    dot,
+    percent,
+    sun,
+    blank
+};
+
+/*********************************************************************
+* @fn                - load_custom_char
+*
+* @brief             - uploads a flash resident glyph to the lcd cgram
+*
+* @param[in]         - reference to lcd object
+* @param[in]         - cgram slot (0-7)
+* @param[in]         - glyph bitmap stored in PROGMEM
+*
+* @return            - none
+*
+* @Note              - the bitmap goes through a small stack buffer
+*                      since createChar expects a ram pointer
+*********************************************************************/
+void load_custom_char(LiquidCrystal_I2C& lcd, uint8_t slot, const uint8_t* glyph) {
+    uint8_t buf[8];
+    memcpy_P(buf, glyph, sizeof(buf));
+    lcd.createChar(slot, buf);
+}
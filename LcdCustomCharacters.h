@@ -8,89 +8,43 @@
  */
 #pragma once
 
-uint8_t select_arrow[8] = {
-	B00000,
-	B00100,
-	B00110,
-	B11111,
-	B00110,
-	B00100,
-	B00000,
-};
-
-uint8_t back_arrow[8] = {
-  B00000,
-  B00101,
-  B01101,
-  B11111,
-  B01100,
-  B00100,
-  B00000,
-  B00000
-};
-
-uint8_t thermometer[8] = {
-  B00100,
-  B01110,
-  B00100,
-  B00100,
-  B00100,
-  B00100,
-  B00100,
-  B00000
-};
-
-uint8_t battery[8] = {
-  B00110,
-  B01111,
-  B01001,
-  B01111,
-  B01111,
-  B01111,
-  B01111,
-  B00000
-};
-
-uint8_t dot[8] = {
-  B00000,
-  B00000,
-  B01100,
-  B11110,
-  B11110,
-  B01100,
-  B00000,
-  B00000
-};
-
-uint8_t percent[8] = {
-  B11000,
-  B11001,
-  B00010,
-  B00100,
-  B01000,
-  B10011,
-  B00011,
-  B00000
-};
-
-uint8_t sun[8] = {
-  B00100,
-  B10101,
-  B01110,
-  B11011,
-  B01110,
-  B10101,
-  B00100,
-  B00000
-};
-
-uint8_t blank[8] = {
-  B00000,
-  B00000,
-  B00000,
-  B00000,
-  B00000,
-  B00000,
-  B00000,
-  B00000
-};
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include <LiquidCrystal_I2C.h>
+
+// logical glyph ids, the cgram slot a glyph lands in is picked at
+// runtime by the glyph cache
+enum Symbols : uint8_t {
+    SELECT_ARROW,
+    BACK_ARROW,
+    THERMOMETER,
+    BATTERY,
+    DOT,
+    PERCENT,
+    SUN,
+    BLANK,
+    // bitmaps built at runtime, see GlyphCache::define
+    SPARK_0,
+    SPARK_1,
+    SPARK_2,
+    SPARK_3,
+    GLYPH_COUNT
+};
+
+// first glyph without a flash bitmap
+const uint8_t dynamic_glyphs = SPARK_0;
+
+// 5x8 glyph bitmaps, stored in flash
+extern const uint8_t select_arrow[8] PROGMEM;
+extern const uint8_t back_arrow[8] PROGMEM;
+extern const uint8_t thermometer[8] PROGMEM;
+extern const uint8_t battery[8] PROGMEM;
+extern const uint8_t dot[8] PROGMEM;
+extern const uint8_t percent[8] PROGMEM;
+extern const uint8_t sun[8] PROGMEM;
+extern const uint8_t blank[8] PROGMEM;
+
+// flash bitmaps indexed by Symbols, up to dynamic_glyphs
+extern const uint8_t* const glyph_bitmaps[] PROGMEM;
+
+void load_custom_char(LiquidCrystal_I2C& lcd, uint8_t slot, const uint8_t* glyph);
@@ -0,0 +1,105 @@
+/**
+ * @file Memory.cpp
+ *
+ * @brief Runtime memory diagnostics definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "Memory.h"
+
+// linker and avr-libc symbols
+extern uint8_t __data_start;
+extern uint8_t __data_end;
+extern uint8_t __bss_start;
+extern uint8_t __bss_end;
+extern uint8_t __heap_start;
+extern char* __brkval;
+
+namespace Memory {
+    // helper functions prototypes
+    uint8_t* heap_end();
+    void paint() __attribute__((naked, used, section(".init1")));
+
+    /********* static sizes api *********/
+    uint16_t data_size() {
+        return &__data_end - &__data_start;
+    }
+
+    uint16_t bss_size() {
+        return &__bss_end - &__bss_start;
+    }
+
+    /********* runtime api *********/
+    uint16_t heap_size() {
+        return heap_end() - &__heap_start;
+    }
+
+    uint16_t free_now() {
+        return reinterpret_cast<uint8_t*>(SP) - heap_end();
+    }
+
+    /*********************************************************************
+    * @fn                - never_used
+    *
+    * @brief             - bytes between the heap and the stack that
+    *                      still hold the canary painted at boot
+    *
+    * @param[in]         - none
+    *
+    * @return            - untouched bytes, the worst case margin so far
+    *
+    * @Note              - scans up from the heap until the first byte
+    *                      the stack has written, about 1 KB at most
+    *********************************************************************/
+    uint16_t never_used() {
+        const uint8_t* p = heap_end();
+        const uint8_t* sp = reinterpret_cast<const uint8_t*>(SP);
+        uint16_t count = 0;
+        while (p < sp && *p == canary) {
+            ++p;
+            ++count;
+        }
+        return count;
+    }
+
+    uint16_t stack_peak() {
+        // lowest address the stack ever reached
+        uintptr_t deepest = reinterpret_cast<uintptr_t>(heap_end()) + never_used();
+        return RAMEND + 1 - deepest;
+    }
+
+    void print() {
+        Serial.print(F("mem: data="));  Serial.print(data_size());
+        Serial.print(F(" bss="));       Serial.print(bss_size());
+        Serial.print(F(" heap="));      Serial.print(heap_size());
+        Serial.print(F(" free="));      Serial.print(free_now());
+        Serial.print(F(" stack peak=")); Serial.print(stack_peak());
+        Serial.print(F(" never used=")); Serial.println(never_used());
+    }
+
+    // helper functions
+    uint8_t* heap_end() {
+        return __brkval ? reinterpret_cast<uint8_t*>(__brkval) : &__heap_start;
+    }
+
+    // runs before the c runtime sets up the stack, so it is plain
+    // assembly: fills everything above .bss up to RAMEND with the canary
+    void paint() {
+        __asm volatile (
+            "    ldi r30, lo8(__heap_start) \n"
+            "    ldi r31, hi8(__heap_start) \n"
+            "    ldi r24, %0                \n"
+            "    ldi r25, hi8(%1)           \n"
+            "    rjmp 2f                    \n"
+            "1:  st Z+, r24                 \n"
+            "2:  cpi r30, lo8(%1)           \n"
+            "    cpc r31, r25               \n"
+            "    brlo 1b                    \n"
+            "    breq 1b                    \n"
+            :
+            : "i" (canary), "i" (RAMEND)
+        );
+    }
+}
@@ -0,0 +1,29 @@
+/**
+ * @file Memory.h
+ *
+ * @brief Runtime memory diagnostics: static sizes, heap, free ram and
+ *        the stack high-water mark
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace Memory {
+    // value painted over the free ram at boot
+    const uint8_t canary = 0xC5;
+
+    /********* static sizes api *********/
+    uint16_t data_size();
+    uint16_t bss_size();
+
+    /********* runtime api *********/
+    uint16_t heap_size();
+    uint16_t free_now();
+    uint16_t stack_peak();
+    uint16_t never_used();
+
+    void print();
+}
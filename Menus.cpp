@@ -1,5 +1,5 @@
 /**
- * @file Menus.h
+ * @file Menus.cpp
  *
  * @brief Menu constants and definitions
  *
@@ -7,3 +7,88 @@
  *
  */
 #include "Menus.h"
+
+// labels
+const char lbl_empty[]          PROGMEM = "";
+const char lbl_commands[]       PROGMEM = "COMMANDS";
+const char lbl_operation_mode[] PROGMEM = "OPERATION MODE";
+const char lbl_return_home[]    PROGMEM = "RETURN HOME";
+const char lbl_lights[]         PROGMEM = "LIGHTS";
+const char lbl_back[]           PROGMEM = "BACK";
+const char lbl_manual[]         PROGMEM = "MANUAL";
+const char lbl_auto[]           PROGMEM = "AUTO";
+const char lbl_confirm[]        PROGMEM = "CONFIRM";
+const char lbl_on[]             PROGMEM = "ON";
+const char lbl_off[]            PROGMEM = "OFF";
+const char lbl_vehicles[]       PROGMEM = "VEHICLES";
+const char lbl_all_vehicles[]   PROGMEM = "ALL (SLOTTED)";
+const char lbl_pair_new[]       PROGMEM = "PAIR NEW";
+const char lbl_pairing[]        PROGMEM = "PAIRING...";
+const char lbl_trends[]         PROGMEM = "TRENDS";
+const char lbl_calibrate_tilt[] PROGMEM = "CALIBRATE TILT";
+const char lbl_hold_still[]     PROGMEM = "HOLD STILL";
+const char lbl_press_cancel[]   PROGMEM = "PRESS TO CANCEL";
+const char lbl_calibrated[]     PROGMEM = "CALIBRATED";
+const char lbl_cancelled[]      PROGMEM = "CANCELLED";
+const char lbl_tuning[]         PROGMEM = "TUNING";
+const char lbl_save_profile[]   PROGMEM = "SAVE PROFILE";
+const char lbl_saved[]          PROGMEM = "SAVED";
+const char lbl_not_saved[]      PROGMEM = "NOT SAVED";
+
+// indexed by Label
+const char* const labels[] PROGMEM = {
+    lbl_empty,
+    lbl_commands,
+    lbl_operation_mode,
+    lbl_return_home,
+    lbl_lights,
+    lbl_back,
+    lbl_manual,
+    lbl_auto,
+    lbl_confirm,
+    lbl_on,
+    lbl_off,
+    lbl_vehicles,
+    lbl_all_vehicles,
+    lbl_pair_new,
+    lbl_pairing,
+    lbl_trends,
+    lbl_calibrate_tilt,
+    lbl_hold_still,
+    lbl_press_cancel,
+    lbl_calibrated,
+    lbl_cancelled,
+    lbl_tuning,
+    lbl_save_profile,
+    lbl_saved,
+    lbl_not_saved
+};
+
+// status line formats
+const char fmt_tx_status[]     PROGMEM = "TX:   %dC   %d";
+const char fmt_veh_status[]    PROGMEM = "VEH:  %dC   %d";
+const char fmt_vehicle[]       PROGMEM = "VEHICLE %d";
+const char fmt_fleet_single[]  PROGMEM = "ACTIVE: V%d";
+const char fmt_fleet_slotted[] PROGMEM = "ALL: %d VEH";
+const char fmt_mem_free[]      PROGMEM = "RAM %u MIN %u";
+const char fmt_mem_static[]    PROGMEM = "D%u B%u S%u";
+const char fmt_tuning_value[]  PROGMEM = "%-10s%5d";
+const char fmt_tuning_live[]   PROGMEM = "L%5uus A%3u%%";
+
+/*********************************************************************
+* @fn                - menu_label
+*
+* @brief             - copies a menu label from flash
+*
+* @param[in]         - label id
+* @param[out]        - destination buffer, at least 16 bytes
+*
+* @return            - none
+*
+* @Note              - none
+*********************************************************************/
+void menu_label(Label id, char* buf) {
+    PGM_P label = static_cast<PGM_P>(pgm_read_ptr(&labels[static_cast<uint8_t>(id)]));
+    strncpy_P(buf, label, 15);
+    buf[15] = '\0';
+}
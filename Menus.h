@@ -9,6 +9,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <avr/pgmspace.h>
 
 
 enum class ActiveMenu {
@@ -16,7 +17,11 @@ enum class ActiveMenu {
     COMMANDS,
     OPERATION_MODE,
     RETURN_HOME,
-    LIGHTS  
+    LIGHTS,
+    VEHICLES,
+    TRENDS,
+    CALIBRATE,
+    TUNING
 };
 
 // commands available
@@ -47,3 +52,46 @@ enum class Lights {
     AUTO,
     CANCEL  
 };
+
+// menu labels, stored in flash
+enum class Label : uint8_t {
+    EMPTY,
+    COMMANDS,
+    OPERATION_MODE,
+    RETURN_HOME,
+    LIGHTS,
+    BACK,
+    MANUAL,
+    AUTO,
+    CONFIRM,
+    ON,
+    OFF,
+    VEHICLES,
+    ALL_VEHICLES,
+    PAIR_NEW,
+    PAIRING,
+    TRENDS,
+    CALIBRATE_TILT,
+    HOLD_STILL,
+    PRESS_TO_CANCEL,
+    CALIBRATED,
+    CANCELLED,
+    TUNING,
+    SAVE_PROFILE,
+    SAVED,
+    NOT_SAVED
+};
+
+// status line formats, stored in flash
+extern const char fmt_tx_status[] PROGMEM;
+extern const char fmt_veh_status[] PROGMEM;
+extern const char fmt_vehicle[] PROGMEM;
+extern const char fmt_fleet_single[] PROGMEM;
+extern const char fmt_fleet_slotted[] PROGMEM;
+extern const char fmt_mem_free[] PROGMEM;
+extern const char fmt_mem_static[] PROGMEM;
+extern const char fmt_tuning_value[] PROGMEM;
+extern const char fmt_tuning_live[] PROGMEM;
+
+// copies the label into buf (16 bytes)
+void menu_label(Label id, char* buf);
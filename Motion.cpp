@@ -0,0 +1,101 @@
+/**
+ * @file Motion.cpp
+ *
+ * @brief Imu sample history definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Motion.h"
+#include "Latency.h"
+#include <string.h>
+
+namespace Motion {
+    struct Entry {
+        int8_t x_acc;
+        int8_t y_acc;
+        uint16_t stamp;
+    };
+
+    // settings
+    bool _enabled = true;
+
+    // samples taken since the last frame, oldest first
+    Entry _history[history_size];
+    uint8_t _count = 0;
+
+    /********* settings api *********/
+    bool enabled() {
+        return _enabled;
+    }
+
+    void enabled(bool val) {
+        _enabled = val;
+        _count = 0;
+    }
+
+    /*********************************************************************
+    * @fn                - push
+    *
+    * @brief             - records an imu sample
+    *
+    * @param[in]         - raw x acceleration
+    * @param[in]         - raw y acceleration
+    *
+    * @return            - none
+    *
+    * @Note              - when the history is full the oldest sample
+    *                      is dropped
+    *********************************************************************/
+    void push(int16_t x_acc, int16_t y_acc) {
+        if (!_enabled) return;
+
+        if (_count == history_size) {
+            memmove(_history, _history + 1, sizeof(Entry) * (history_size - 1));
+            --_count;
+        }
+        Entry& e = _history[_count++];
+        e.x_acc = x_acc >> 8;
+        e.y_acc = y_acc >> 8;
+        e.stamp = Latency::stamp();
+    }
+
+    /*********************************************************************
+    * @fn                - pack
+    *
+    * @brief             - copies the samples taken since the last frame
+    *                      into the frame's motion block
+    *
+    * @param[out]        - motion block to fill
+    * @param[in]         - tx_stamp of the frame the block goes with
+    *
+    * @return            - number of bytes used in the block
+    *
+    * @Note              - with more samples than fit, the oldest, the
+    *                      newest and evenly spaced ones in between are
+    *                      kept, so the whole interval stays covered. The
+    *                      history is only cleared by sent(), a frame the
+    *                      radio did not take leaves it for the next one
+    *********************************************************************/
+    uint8_t pack(MotionBlock& block, uint16_t tx_stamp) {
+        uint8_t n = (_count < max_motion_samples) ? _count : max_motion_samples;
+
+        for (uint8_t i = 0; i < n; ++i) {
+            uint8_t src = (n > 1) ? static_cast<uint16_t>(i) * (_count - 1) / (n - 1) : _count - 1;
+            const Entry& e = _history[src];
+            uint16_t age = static_cast<uint16_t>(tx_stamp - e.stamp) >> 6;
+
+            block.samples[i].x_acc = e.x_acc;
+            block.samples[i].y_acc = e.y_acc;
+            block.samples[i].age = (age > 255) ? 255 : age;
+        }
+        block.count = n;
+
+        return motion_block_len(n);
+    }
+
+    // the frame with the last packed block was queued
+    void sent() {
+        _count = 0;
+    }
+}
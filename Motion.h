@@ -0,0 +1,26 @@
+/**
+ * @file Motion.h
+ *
+ * @brief Imu sample history packed into each frame
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include "DataPackage.h"
+
+namespace Motion {
+    // samples kept between two frames
+    const uint8_t history_size = 8;
+
+    /********* settings api *********/
+    bool enabled();
+    void enabled(bool val);
+
+    // utility functions
+    void push(int16_t x_acc, int16_t y_acc);
+    uint8_t pack(MotionBlock& block, uint16_t tx_stamp);
+    void sent();
+}
@@ -99,23 +99,23 @@ namespace Mpu6050 {
     }
     
     /********* Mpu-6050 class getters *********/
-    uint8_t Instance::left() {
+    uint8_t Instance::left() const {
         return this->_left;
     }
     
-    uint8_t Instance::right() {
+    uint8_t Instance::right() const {
         return this->_right;
     }
     
-    uint8_t Instance::down() {
+    uint8_t Instance::down() const {
         return this->_down;
     }
     
-    uint8_t Instance::up() {
+    uint8_t Instance::up() const {
         return this->_up;
     }
 
-    int8_t Instance::temp() {
+    int8_t Instance::temp() const {
         return this->_temp;
     }
     
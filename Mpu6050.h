@@ -53,14 +53,25 @@ namespace Mpu6050 {
     extern int16_t _min_y_acc;
     extern int16_t _max_y_acc;
     
+    // raw register values, in the order they are read from the device
+    struct RawData {
+        int16_t x_acc;
+        int16_t y_acc;
+        int16_t z_acc;
+        int16_t temp;
+        int16_t x_gyro;
+        int16_t y_gyro;
+        int16_t z_gyro;
+    };
+
     class Instance{
     public:
         // getters
-        uint8_t left();
-        uint8_t right();
-        uint8_t down();
-        uint8_t up();
-        int8_t temp();
+        uint8_t left() const;
+        uint8_t right() const;
+        uint8_t down() const;
+        uint8_t up() const;
+        int8_t temp() const;
     
         // setters
         void left(uint8_t val);
@@ -0,0 +1,221 @@
+/**
+ * @file Power.cpp
+ *
+ * @brief Idle detection and low power handling definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Power.h"
+#include "RotaryEncoder.h"
+#include "RadioTx.h"
+#include "Control.h"
+#include "Board.h"
+#include "Arduino.h"
+#include <avr/sleep.h>
+
+// the buttons wake the board through ISR(PCINT2_vect)
+static_assert(Board::ReSw::port == Board::port_d &&
+              Board::J1Sw::port == Board::port_d &&
+              Board::J2Sw::port == Board::port_d,
+              "buttons must be on PCINT2");
+
+namespace Power {
+    // settings
+    uint16_t _idle_timeout_ms = 10000;
+    uint16_t _heartbeat_ms = 250;
+
+    // state
+    bool _idle = false;
+    bool _radio_down = false;
+    bool _down_pending = false;
+    volatile bool _wake = false;
+    unsigned long _last_activity_ms = 0;
+    unsigned long _last_tick_ms = 0;
+    unsigned long _last_send_ms = 0;
+    int _last_pos = 0;
+
+    // helper functions prototypes
+    bool has_input(const DataPackage& data_pkg);
+
+    /********* power settings api *********/
+    uint16_t idle_timeout_ms() {
+        return _idle_timeout_ms;
+    }
+
+    uint16_t heartbeat_ms() {
+        return _heartbeat_ms;
+    }
+
+    void idle_timeout_ms(uint16_t val) {
+        _idle_timeout_ms = val;
+    }
+
+    void heartbeat_ms(uint16_t val) {
+        _heartbeat_ms = val;
+    }
+
+    /********* state api *********/
+    bool idle() {
+        return _idle;
+    }
+
+    void wake() {
+        _wake = true;
+    }
+
+    /*********************************************************************
+    * @fn                - config_power
+    *
+    * @brief             - enables the pin change interrupts used to
+    *                      wake up from sleep
+    *
+    * @param[in]         - none
+    *
+    * @return            - none
+    *
+    * @Note              - D4 (rot enc sw), D5 (j1 sw) and D6 (j2 sw)
+    *                      share PCINT2, the rot enc clk already has
+    *                      its own external interrupt
+    *********************************************************************/
+    void config_power() {
+        Board::ReSw::enable_pcint();
+        Board::J1Sw::enable_pcint();
+        Board::J2Sw::enable_pcint();
+
+        _last_activity_ms = millis();
+        _last_tick_ms = _last_activity_ms;
+
+        Serial.println(F("    Power config complete!"));
+    }
+
+    /*********************************************************************
+    * @fn                - update
+    *
+    * @brief             - tracks user activity and switches between
+    *                      active and idle modes
+    *
+    * @param[in]         - reference to lcd object
+    * @param[in]         - latest input data
+    *
+    * @return            - none
+    *
+    * @Note              - joystick and tilt movement is detected from
+    *                      the processed frame, so it is noticed at the
+    *                      latest one control period after it happens
+    *********************************************************************/
+    void update(LiquidCrystal_I2C& lcd, const DataPackage& data_pkg) {
+        unsigned long now = millis();
+
+        bool active = _wake || has_input(data_pkg) || virtual_pos != _last_pos;
+        _wake = false;
+        _last_pos = virtual_pos;
+
+        if (active) {
+            _last_activity_ms = now;
+            if (_idle) {
+                _idle = false;
+                lcd.backlight();
+            }
+        } else if (!_idle && now - _last_activity_ms >= _idle_timeout_ms) {
+            _idle = true;
+            lcd.noBacklight();
+        }
+    }
+
+    /*********************************************************************
+    * @fn                - send_due
+    *
+    * @brief             - tells whether a frame should be sent this
+    *                      iteration, powering the radio up if needed
+    *
+    * @param[in]         - reference to radio object (RF24)
+    *
+    * @return            - true when a frame should be sent
+    *
+    * @Note              - while idle only heartbeats are sent
+    *********************************************************************/
+    bool send_due(RF24& radio) {
+        if (_idle && millis() - _last_send_ms < _heartbeat_ms) return false;
+
+        if (_radio_down) {
+            radio.powerUp();
+            _radio_down = false;
+        }
+        return true;
+    }
+
+    /*********************************************************************
+    * @fn                - sent
+    *
+    * @brief             - powers the radio down after a heartbeat
+    *
+    * @param[in]         - reference to radio object (RF24)
+    *
+    * @return            - none
+    *
+    * @Note              - the frame is only queued, so the power down
+    *                      waits until it left the tx fifo
+    *********************************************************************/
+    void sent(RF24& radio) {
+        _last_send_ms = millis();
+        _down_pending = _idle;
+        settle(radio);
+    }
+
+    void settle(RF24& radio) {
+        if (!_down_pending || !RadioTx::idle()) return;
+        radio.powerDown();
+        _radio_down = true;
+        _down_pending = false;
+    }
+
+    /*********************************************************************
+    * @fn                - sleep
+    *
+    * @brief             - while idle, sleeps until the control isr
+    *                      publishes a frame or until user activity wakes
+    *                      us up
+    *
+    * @param[in]         - none
+    *
+    * @return            - none
+    *
+    * @Note              - idle sleep mode keeps timer0 and timer1
+    *                      running, so millis() stays valid and the
+    *                      control isr keeps sampling (the adc stays on
+    *                      for it) while the loop sleeps. The period of
+    *                      the control timer bounds the wait
+    *********************************************************************/
+    void sleep() {
+        if (_idle) {
+            set_sleep_mode(SLEEP_MODE_IDLE);
+
+            while (millis() - _last_tick_ms < Control::period_ms()) {
+                cli();
+                if (_wake || Control::pending()) {
+                    sei();
+                    break;
+                }
+                sleep_enable();
+                sei();          // the next instruction runs before any isr
+                sleep_cpu();
+                sleep_disable();
+            }
+        }
+        _last_tick_ms = millis();
+    }
+
+    // helper functions
+    bool has_input(const DataPackage& data_pkg) {
+        return data_pkg.j1.left || data_pkg.j1.right || data_pkg.j1.down || data_pkg.j1.up
+            || data_pkg.j2.left || data_pkg.j2.right || data_pkg.j2.down || data_pkg.j2.up
+            || data_pkg.mpu.left() || data_pkg.mpu.right() || data_pkg.mpu.down() || data_pkg.mpu.up();
+    }
+}
+
+// any of the buttons changed
+ISR(PCINT2_vect) {
+    Power::wake();
+    rot_button_isr();
+}
@@ -0,0 +1,36 @@
+/**
+ * @file Power.h
+ *
+ * @brief Idle detection and low power handling
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <LiquidCrystal_I2C.h>
+#include <RF24.h>
+#include "DataPackage.h"
+
+namespace Power {
+    /********* power settings api *********/
+    uint16_t idle_timeout_ms();
+    uint16_t heartbeat_ms();
+    void idle_timeout_ms(uint16_t val);
+    void heartbeat_ms(uint16_t val);
+
+    /********* state api *********/
+    bool idle();
+    bool send_due(RF24& radio);
+    void sent(RF24& radio);
+    void settle(RF24& radio);
+
+    // utility functions
+    void config_power();
+    void update(LiquidCrystal_I2C& lcd, const DataPackage& data_pkg);
+    void sleep();
+
+    // called from interrupts on user activity
+    void wake();
+}
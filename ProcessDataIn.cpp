@@ -0,0 +1,94 @@
+/**
+ * @file ProcessDataIn.cpp
+ *
+ * @brief Frame decoding definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+// no Arduino.h here, the decoder is also built on the host by
+// tools/rx_bench.py against a loopback radio
+#include "ProcessDataIn.h"
+#include "CommandCodes.h"
+#ifdef ARDUINO
+#include <RF24.h>
+#endif
+
+namespace ProcessDataIn {
+    /*********************************************************************
+    * @fn                - decode
+    *
+    * @brief             - validates a payload and unpacks it into a
+    *                      frame
+    *
+    * @param[in]         - payload as read from the rx fifo
+    * @param[in]         - payload length
+    * @param[out]        - decoded frame, only complete when OK
+    *
+    * @return            - OK or the reason the payload was rejected
+    *
+    * @Note              - the nrf24 crc already dropped corrupted
+    *                      payloads, this catches frames that do not
+    *                      match the layout of their profile or carry
+    *                      impossible values. Stale frames are left to
+    *                      the Receiver, which knows the last accepted
+    *                      stamp
+    *********************************************************************/
+    Decode decode(const uint8_t* buf, uint8_t len, Frame& frame) {
+        if (len < frame_header_len) return Decode::BAD_LENGTH;
+
+        // the header says which inputs follow
+        uint8_t inputs = InputProfile::inputs(buf[0]);
+        if (inputs == 0) return Decode::BAD_PROFILE;
+        uint8_t plain_len = frame_len(buf[0]);
+        if (len < plain_len) return Decode::BAD_LENGTH;
+
+        memset(&frame.pkg, 0, sizeof(frame.pkg));
+        memcpy(&frame.pkg, buf, frame_header_len);
+        const uint8_t* in = buf + frame_header_len;
+        if (inputs & InputProfile::J1) {
+            memcpy(&frame.pkg.j1, in, joystick_len);
+            in += joystick_len;
+        }
+        if (inputs & InputProfile::J2) {
+            memcpy(&frame.pkg.j2, in, joystick_len);
+            in += joystick_len;
+        }
+        if (inputs & InputProfile::IMU) {
+            memcpy(&frame.pkg.mpu, in, mpu_len);
+        }
+        frame.motion.count = 0;
+
+        if (len > plain_len) {
+            // motion frame, the block length follows from its count,
+            // only profiles with tilt have samples to send
+            uint8_t count = buf[plain_len];
+            if (!(inputs & InputProfile::IMU) || count > max_motion_samples ||
+                len != plain_len + motion_block_len(count)) {
+                return Decode::BAD_LENGTH;
+            }
+            memcpy(&frame.motion, buf + plain_len, motion_block_len(count));
+
+            // Motion::pack sends the samples oldest first
+            for (uint8_t i = 1; i < count; ++i) {
+                if (frame.motion.samples[i].age > frame.motion.samples[i - 1].age) {
+                    return Decode::BAD_MOTION;
+                }
+            }
+        }
+
+        if (frame.pkg.menu_select >= command_count) return Decode::BAD_COMMAND;
+        return Decode::OK;
+    }
+
+    // true if stamp was taken after last, valid within half a wrap
+    bool newer(uint16_t stamp, uint16_t last) {
+        return static_cast<int16_t>(stamp - last) > 0;
+    }
+}
+
+#ifdef ARDUINO
+// the firmware build instantiates the receiver against the real
+// radio library, so the vehicle side is compiled with every sketch
+template class ProcessDataIn::Receiver<RF24>;
+#endif
@@ -1,9 +1,267 @@
 /**
  * @file ProcessDataIn.h
  *
- * @brief Process incoming data functions declarations
+ * @brief Vehicle side of the link, frame decoding and the receive
+ *        engine, built from the same DataPackage as the transmitter
  *
  * @author Gustavo Monardez
  *
  */
 #pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "DataPackage.h"
+#include "Downlink.h"
+
+namespace ProcessDataIn {
+    // outcome of decoding one payload
+    enum class Decode : uint8_t {
+        OK,
+        BAD_LENGTH,     // neither a plain nor a motion frame
+        BAD_COMMAND,    // menu_select is not a command code
+        BAD_MOTION,     // motion samples out of order
+        BAD_PROFILE,    // not an InputProfile::Id
+        DUPLICATE,      // same tx_stamp, the ack was lost and resent
+        STALE,          // older than the last accepted frame
+        DECODE_COUNT
+    };
+
+    // decoded frame, the inputs outside its profile (pkg.profile) are
+    // at rest, motion.count is 0 for plain frames
+    struct Frame {
+        DataPackage pkg;
+        MotionBlock motion;
+    };
+
+    // time without a valid frame before the outputs go neutral, kept
+    // below half the tx_stamp wrap (~131ms) so stamps stay comparable
+    const uint32_t max_silence_us = 120000;
+
+    // utility functions
+    Decode decode(const uint8_t* buf, uint8_t len, Frame& frame);
+    bool newer(uint16_t stamp, uint16_t last);
+
+    /*********************************************************************
+    * @brief             - receive engine, one per vehicle
+    *
+    * @Note              - Radio is RF24 on the vehicle, or a loopback
+    *                      stand-in on the host (tools/rx_bench), it
+    *                      needs available, getDynamicPayloadSize, read,
+    *                      writeAckPayload and whatHappened. Dynamic and
+    *                      ack payloads must be enabled and the radio
+    *                      listening on pipe before begin is called
+    *********************************************************************/
+    template <class Radio>
+    class Receiver {
+    public:
+        explicit Receiver(Radio& radio) :
+            _radio(radio), _pipe(1), _use_irq(false), _irq(false),
+            _silence_us(100000), _link(false), _last_stamp(0),
+            _last_frame_us(0), _last_drain_us(0), _interval_ticks(0),
+            _frames(0), _timeouts(0), _irq_misses(0) {
+            memset(&_frame, 0, sizeof(_frame));
+            memset(&_ack, 0, sizeof(_ack));
+            memset(_rejected, 0, sizeof(_rejected));
+        }
+
+        /********* settings api *********/
+        uint32_t silence_us() const {
+            return _silence_us;
+        }
+
+        void silence_us(uint32_t val) {
+            _silence_us = (val > max_silence_us) ? max_silence_us : val;
+        }
+
+        /********* counters api *********/
+        uint16_t frames() const {
+            return _frames;
+        }
+
+        uint16_t rejected(Decode reason) const {
+            return _rejected[static_cast<uint8_t>(reason)];
+        }
+
+        uint16_t timeouts() const {
+            return _timeouts;
+        }
+
+        uint16_t irq_misses() const {
+            return _irq_misses;
+        }
+
+        /*****************************************************************
+        * @fn                - begin
+        *
+        * @brief             - stages the first ack payload
+        *
+        * @param[in]         - reading pipe the transmitter writes to
+        * @param[in]         - true to drain the fifo only on the irq pin
+        * @param[in]         - current time, micros()
+        *
+        * @return            - none
+        *
+        * @Note              - outputs are neutral until the first frame
+        *****************************************************************/
+        void begin(uint8_t pipe, bool use_irq, uint32_t now_us) {
+            _pipe = pipe;
+            _use_irq = use_irq;
+            _last_drain_us = now_us;
+            _last_frame_us = now_us;
+            stage_ack();
+        }
+
+        // call from the isr of the radio irq pin (active low)
+        void irq() {
+            _irq = true;
+        }
+
+        /*****************************************************************
+        * @fn                - service
+        *
+        * @brief             - drains the rx fifo and runs the watchdog
+        *
+        * @param[in]         - current time, micros()
+        *
+        * @return            - true if a new frame was accepted
+        *
+        * @Note              - in irq mode the spi is only touched after
+        *                      an irq, or when none came for a quarter of
+        *                      the silence time (counted as a miss)
+        *****************************************************************/
+        bool service(uint32_t now_us) {
+            bool accepted = false;
+
+            bool drain = !_use_irq || _irq;
+            if (!drain && now_us - _last_drain_us > (_silence_us >> 2)) {
+                ++_irq_misses;
+                drain = true;
+            }
+            if (drain) {
+                _irq = false;
+                _last_drain_us = now_us;
+                if (_use_irq) {
+                    bool tx_ok, tx_fail, rx_ready;
+                    _radio.whatHappened(tx_ok, tx_fail, rx_ready);
+                }
+                while (_radio.available()) {
+                    accepted |= receive(now_us);
+                }
+            }
+
+            // silence, every output goes to rest
+            if (_link && now_us - _last_frame_us > _silence_us) {
+                _link = false;
+                ++_timeouts;
+                memset(&_frame, 0, sizeof(_frame));
+            }
+            return accepted;
+        }
+
+        /*****************************************************************
+        * @fn                - telemetry
+        *
+        * @brief             - sets the readings sent back in the acks
+        *
+        * @param[in]         - readings of channels 0.., the first ones
+        *                      are Telemetry::Channel
+        * @param[in]         - number of readings, up to channel_count
+        *
+        * @return            - none
+        *
+        * @Note              - every channel goes out at its downlink
+        *                      period, set through downlink(), the next
+        *                      ack is already staged
+        *****************************************************************/
+        void telemetry(const int8_t* data, uint8_t len) {
+            for (uint8_t ch = 0; ch < len; ++ch) _downlink.value(ch, data[ch]);
+        }
+
+        Downlink::Scheduler& downlink() {
+            return _downlink;
+        }
+
+        // newest accepted frame, all zero while the link is down
+        const Frame& frame() const {
+            return _frame;
+        }
+
+        bool link() const {
+            return _link;
+        }
+
+    private:
+        bool receive(uint32_t now_us) {
+            uint8_t buf[32];
+            uint8_t len = _radio.getDynamicPayloadSize();
+            if (len > sizeof(buf)) len = sizeof(buf);
+            _radio.read(buf, len);
+
+            Frame frame;
+            Decode result = decode(buf, len, frame);
+            if (result == Decode::OK && _link) {
+                if (frame.pkg.tx_stamp == _last_stamp) result = Decode::DUPLICATE;
+                else if (!newer(frame.pkg.tx_stamp, _last_stamp)) result = Decode::STALE;
+            }
+
+            // every payload read used up one staged ack, rejected or not
+            if (result != Decode::OK) {
+                ++_rejected[static_cast<uint8_t>(result)];
+                stage_ack();
+                return false;
+            }
+
+            // inter-arrival time in stamp ticks, averaged over 8 frames
+            uint16_t ticks = static_cast<uint16_t>((now_us - _last_frame_us) >> 2);
+            if (!_link) _interval_ticks = 0;
+            else if (_interval_ticks == 0) _interval_ticks = ticks;
+            else _interval_ticks += (static_cast<int16_t>(ticks - _interval_ticks)) >> 3;
+
+            _frame = frame;
+            _last_stamp = frame.pkg.tx_stamp;
+            _last_frame_us = now_us;
+            _link = true;
+            ++_frames;
+
+            _ack.echo_stamp = _last_stamp;
+            _ack.hold = _interval_ticks;
+            _downlink.acked(frame.pkg.ack_seq, frame.pkg.ack_bits);
+            stage_ack();
+            return true;
+        }
+
+        // the ack is preloaded before the next frame arrives, so hold is
+        // the mean frame interval, Latency::ack subtracts it on the
+        // transmitter, the error is the jitter of one interval
+        void stage_ack() {
+            uint8_t len = _downlink.encode(reinterpret_cast<uint8_t*>(_ack.telemetry),
+                                           sizeof(_ack.telemetry));
+            _radio.writeAckPayload(_pipe, &_ack, ack_header_size + len);
+        }
+
+        Radio& _radio;
+        uint8_t _pipe;
+        bool _use_irq;
+        volatile bool _irq;
+
+        // settings
+        uint32_t _silence_us;
+
+        // state
+        bool _link;
+        uint16_t _last_stamp;
+        uint32_t _last_frame_us;
+        uint32_t _last_drain_us;
+        uint16_t _interval_ticks;
+        Frame _frame;
+        AckPackage _ack;
+        Downlink::Scheduler _downlink;
+
+        // counters
+        uint16_t _frames;
+        uint16_t _timeouts;
+        uint16_t _irq_misses;
+        uint16_t _rejected[static_cast<uint8_t>(Decode::DECODE_COUNT)];
+    };
+}
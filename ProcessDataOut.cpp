@@ -12,13 +12,32 @@
 #include "Menus.h"
 #include <Wire.h>               // mpu-6050
 #include "CommandCodes.h"
+#include "Fleet.h"
+#include "Latency.h"
+#include "AxisPipeline.h"
+#include "Fixed.h"
+#include "Deadline.h"
+#include "Display.h"
+#include "I2cArbiter.h"
+#include "Motion.h"
+#include "Telemetry.h"
+#include "TrendView.h"
+#include "LcdCustomCharacters.h"
+#include "Memory.h"
+#include "Events.h"
+#include "RadioTx.h"
+#include "Trace.h"
+#include "Protothread.h"
+#include "Configurations.h"
+#include "Tuning.h"
+#include "Control.h"
+#include <util/atomic.h>
+#include <avr/pgmspace.h>
 
 
 // helper functions prototypes
-void read_mpu_6050_data();
-int16_t get_calibrated_x_acc();
-int16_t get_calibrated_y_acc();
-void draw_menu_page(LiquidCrystal_I2C& lcd, char menu[][16],
+bool read_mpu_6050_data();
+void draw_menu_page(char menu[][16],
                          int8_t start_item,
                          int8_t selector_id,
                          int8_t selector_row,
@@ -28,28 +47,45 @@ void draw_menu_page(LiquidCrystal_I2C& lcd, char menu[][16],
                          int8_t custom_char_4_id = -1,
                          int8_t custom_char_5_id = -1,
                          int8_t custom_char_6_id = -1);
+void vehicle_item_label(uint8_t item, char* buf);
+void apply_vehicle_item(uint8_t item);
+void draw_active_menu(int8_t temp, int8_t data_in[32], bool refresh);
+void select_option(uint8_t& menu_select);
+void draw_labels(Label row_1, Label row_2);
+void tuning_live_line(char* buf);
+void draw_tuning_item(uint8_t item);
+PtState cmd_msg_flow(Pt* pt);
+PtState calibrate_flow(Pt* pt);
                          
-// mpu-6050 raw data variables
-int16_t raw_x_acc;
-int16_t raw_y_acc;
-int16_t raw_z_acc;
-int16_t raw_temp;
-int16_t raw_x_gyro;
-int16_t raw_y_gyro;
-int16_t raw_z_gyro;
-
-// mpu-6050 calibrated data variables
-int16_t calib_x_acc;
-int16_t calib_y_acc;
-int16_t calib_z_acc;
-int16_t calib_temp;
-int16_t calib_x_gyro;
-int16_t calib_y_gyro;
-int16_t calib_z_gyro;
-
-// mpu-6050 pwm variables
-const int16_t pwm_x_val = 255;
-const int16_t pwm_y_val = 255;
+// mpu-6050 raw data, latest sample, and a count of the valid reads so
+// a consumer running every loop can tell a new sample from the last one
+Mpu6050::RawData mpu_raw;
+bool mpu_raw_valid = false;
+uint8_t mpu_raw_seq = 0;
+
+// joystick axes: raw adc values around 505 are the resting position,
+// 501-509 with the default tuning deadzone
+typedef TunedDeadzone<505> JoystickDeadzone;
+typedef AxisPipeline<JoystickX, JoystickDeadzone, LinearCurve, LeftRight> JoystickXLeftRight;
+typedef AxisPipeline<JoystickY, JoystickDeadzone, LinearCurve, UpDown>    JoystickYUpDown;
+typedef AxisPipeline<JoystickX, JoystickDeadzone, LinearCurve, DownUp>    JoystickXDownUp;
+typedef AxisPipeline<JoystickY, JoystickDeadzone, LinearCurve, LeftRight> JoystickYLeftRight;
+
+// mpu-6050 axes: tilt left/right and forward/backward
+typedef AxisPipeline<MpuAccX, CalibratedDeadzoneX, LinearCurve, LeftRight> MpuXLeftRight;
+typedef AxisPipeline<MpuAccY, CalibratedDeadzoneY, LinearCurve, DownUp>    MpuYDownUp;
+
+/* The temperature in degrees C for a given register value may be 
+* computed as:
+* Temperature in degrees 
+* C = (TEMP_OUT Register Value as a signed quantity)/340 + 36.53
+* Page 30 of MPU-6000-Register-Map1.pdf
+*/
+typedef Fixed::Linear<Fixed::q(1, 340, 18), Fixed::q(3653, 100, 18), 18> MpuTempC;
+
+// temperature changes slowly, it is converted once per period
+const uint16_t temp_period_ms = 1000;
+unsigned long last_temp_ms = 0;
 
 // current menu/submenu selected
 uint8_t selected_menu = 0;
@@ -57,6 +93,14 @@ uint8_t selected_submenu = 0;
 
 uint8_t selected_option = static_cast<uint8_t>(CommandCodes::NONE);
 
+// item highlighted on the vehicles submenu
+uint8_t selected_vehicle_item = 0;
+
+// item highlighted on the tuning submenu, turns change its value
+// instead of moving while it is being edited
+uint8_t selected_tuning_item = 0;
+bool tuning_edit = false;
+
 // first time loading a menu/submenu flags
 bool first_time_submenu_options = true;
 bool first_time_submenu = true;
@@ -68,16 +112,21 @@ uint8_t curr_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
 // msg buffer to display when command is sent
 char cmd_msg[16];
 
-enum Symbols : uint8_t {
-    SELECT_ARROW,
-    BACK_ARROW,
-    THERMOMETER,
-    BATTERY,
-    DOT,
-    PERCENT,
-    SUN,
-    BLANK  
-};
+// how long the command message stays on the lcd
+const uint16_t cmd_msg_ms = 3000;
+
+// tilt samples taken by the calibration flow, one per loop
+const uint8_t calibrate_samples = 64;
+
+// command in the frames being sent, and the acked command count when
+// it was first sent, it goes out with full retries until one is acked
+uint8_t sending_cmd = static_cast<uint8_t>(CommandCodes::NONE);
+uint16_t sending_cmd_acks = 0;
+
+// ui flows
+Pt cmd_msg_pt;
+Pt calibrate_pt;
+bool calibrate_cancel = false;
 
 /*********************************************************************
 * @fn                - process_joystick
@@ -92,45 +141,8 @@ enum Symbols : uint8_t {
 *                      as left/right and vry values as down/up
 *********************************************************************/
 void process_joystick(Joystick& j) {
-    // read vx input data
-    int vx_val = analogRead(j.vrx_pin);
-    
-    // read vy input data
-    int vy_val = analogRead(j.vry_pin);
-    
-    // left
-    if (vx_val <= 500) {
-        j.left = map(vx_val, 500, 0, 0, 255);
-        j.right = 0;
-    }
-    // right
-    else if (vx_val >= 510){
-        j.right = map(vx_val, 510, 1023, 0, 255);
-        j.left = 0;
-    }
-    // up / forward
-    if (vy_val <= 500) {
-        j.up = map(vy_val, 500, 0, 0, 255);
-        j.down = 0;
-    }
-    // down / reverse
-    else if (vy_val >= 510){
-        j.down = map(vy_val, 510, 1023, 0, 255);
-        j.up = 0;
-    }
-    
-    // when the value of  vrx and vry is between 501 and 509
-    // it means that the joystick is in its resting position
-    // so we need to make sure all values are set to 0
-    if (vx_val >= 501 && vx_val <= 509) {
-        j.left = 0;
-        j.right = 0;
-    }
-    
-    if (vy_val >= 501 && vy_val <= 509) {
-        j.down = 0;
-        j.up = 0;
-    }
+    JoystickXLeftRight::run(j, j);
+    JoystickYUpDown::run(j, j);
 }
 
 /*********************************************************************
@@ -146,96 +158,68 @@ void process_joystick(Joystick& j) {
 *                      as down/up and vry values as left/right
 *********************************************************************/
 void process_joystick_alt(Joystick& j) {
-    // read vx input data
-    int vx_val = analogRead(j.vrx_pin);
-    
-    // read vy input data
-    int vy_val = analogRead(j.vry_pin);
-    
-    // down / reverse
-    if (vx_val <= 500) {
-        j.down = map(vx_val, 500, 0, 0, 255);
-        j.up = 0;
-    }
-    // up / forward
-    else if (vx_val >= 510){
-        j.up = map(vx_val, 510, 1023, 0, 255);
-        j.down = 0;
-    }
-    // left
-    if (vy_val <= 500) {
-        j.left = map(vy_val, 500, 0, 0, 255);
-        j.right = 0;
-    }
-    // right
-    else if (vy_val >= 510){
-        j.right = map(vy_val, 510, 1023, 0, 255);
-        j.left = 0;
-    }
+    JoystickXDownUp::run(j, j);
+    JoystickYLeftRight::run(j, j);
+}
 
-    // when the value of  vx and vy is between 501 and 509
-    // it means that the joystick is in its resting position
-    // so we need to make sure all values are set to 0
-    if (vx_val >= 501 && vx_val <= 509) {
-        j.down = 0;
-        j.up = 0;
+/*********************************************************************
+* @fn                - process_mpu_6050
+*
+* @brief             - process input data from mpu-6050 (x,y axis)
+*
+* @param[in]         - mpu handle
+* @param[in]         - latest raw sample, nullptr if the read failed
+* 
+* @return            - none
+*
+* @Note              - runs in the control isr, the sample is read by
+*                      the main loop, which owns the i2c bus
+*********************************************************************/
+void process_mpu_6050(Mpu6050::Instance& mpu, const Mpu6050::RawData* raw) {
+    // a failed or timed out transaction reports the mpu at rest
+    if (raw == nullptr) {
+        LeftRight::write(mpu, 0);
+        DownUp::write(mpu, 0);
+        return;
     }
 
-    if (vy_val >= 501 && vy_val <= 509) {
-        j.left = 0;
-        j.right = 0;
+    // left/right and down/up, values within the calibrated
+    // oscillating range read as 0
+    MpuXLeftRight::run(*raw, mpu);
+    MpuYDownUp::run(*raw, mpu);
+
+    // fixed point, rounded to the nearest degree
+    unsigned long now = millis();
+    if (now - last_temp_ms >= temp_period_ms) {
+        last_temp_ms = now;
+        mpu.temp(Fixed::saturate<int8_t>(MpuTempC::apply(raw->temp)));
     }
 }
 
 /*********************************************************************
-* @fn                - process_mpu_6050
+* @fn                - sample_mpu_6050
 *
-* @brief             - process input data from mpu-6050 (x,y axis)
+* @brief             - reads a raw sample from the mpu-6050
 *
-* @param[in]         - Joystick object
+* @param[in]         - none
 * 
 * @return            - none
 *
-* @Note              - alternate version that processes vrx values
-*                      as down/up and vry values as left/right
+* @Note              - registered as the i2c arbiter imu job, so it
+*                      also runs in between lcd chunks and the frame
+*                      can carry the samples taken since the last one
 *********************************************************************/
-void process_mpu_6050(Mpu6050::Instance& mpu) {
-    // read raw data from device
-    read_mpu_6050_data();
+void sample_mpu_6050() {
+    mpu_raw_valid = read_mpu_6050_data();
 
-    // get left/right calibrated data
-    calib_x_acc = get_calibrated_x_acc();
+    // the control isr turns it into tilt on its next tick
+    Control::mpu_sample(mpu_raw_valid ? &mpu_raw : nullptr);
 
-    // get down/up calibrated data
-    calib_y_acc = get_calibrated_y_acc();
-    
-    // save left/right calibrated data on mpu handle
-    if (calib_x_acc < 0) { 
-        // convert to positive num before assigning
-        mpu.left(calib_x_acc * -1);
-        mpu.right(0);
-    } else {
-        mpu.right(calib_x_acc);
-        mpu.left(0);
+    // keep the history sent along with the next frame
+    if (mpu_raw_valid) {
+        ++mpu_raw_seq;
+        Motion::push(mpu_raw.x_acc, mpu_raw.y_acc);
     }
-    
-    // save down/up calibrated data on mpu handle
-    if (calib_y_acc < 0) {
-        // convert to positive num before assigning
-        mpu.down(calib_y_acc  * -1);
-        mpu.up(0);
-    } else {
-        mpu.up(calib_y_acc);
-        mpu.down(0);
-    }
-
-    /* The temperature in degrees C for a given register value may be 
-    * computed as:
-    * Temperature in degrees 
-    * C = (TEMP_OUT Register Value as a signed quantity)/340 + 36.53
-    * Page 30 of MPU-6000-Register-Map1.pdf
-    */
-    mpu.temp(raw_temp/340.00+36.53);
 }
 
 /*********************************************************************
@@ -246,13 +230,221 @@ void process_mpu_6050(Mpu6050::Instance& mpu) {
 * @param[in]         - Display object
 * @param[in]         - menu selection to be updated
 * @param[in]         - current internal temperature
-* @param[in]         - bool that indicates if first time running
+* @param[in]         - telemetry received from the active vehicle
 * 
 * @return            - none
 *
-* @Note              - none
+* @Note              - with no pending events this is one queue check
+*                      plus flushing what is left of the last page
+*********************************************************************/
+void process_display(LiquidCrystal_I2C& lcd, uint8_t& menu_select, int8_t temp, int8_t data_in[32]) {
+    // the menus only run when the knob or the telemetry changed
+    Events::Event ev;
+    while (Events::next(ev)) {
+        Trace::record(Trace::Event::UI_EVENT, static_cast<uint8_t>(ev.type));
+
+        // the calibration flow owns the lcd, a press cancels it
+        if (PT_RUNNING(&calibrate_pt)) {
+            if (ev.type == Events::Type::PRESS) calibrate_cancel = true;
+            continue;
+        }
+
+        if (ev.type == Events::Type::TURN && tuning_edit) {
+            // the knob steps the tuning value in place
+            Tuning::step(static_cast<Tuning::Param>(selected_tuning_item), ev.arg);
+            first_time_submenu = true;
+        } else if (ev.type == Events::Type::TURN) {
+            virtual_pos += ev.arg;
+        } else if (ev.type == Events::Type::PRESS) {
+            select_option(menu_select);
+        }
+        draw_active_menu(temp, data_in, ev.type == Events::Type::REFRESH);
+    }
+
+    // flows resume where they waited, they never block
+    calibrate_flow(&calibrate_pt);
+    cmd_msg_flow(&cmd_msg_pt);
+
+    // push whatever changed to the lcd, one slice per call
+    I2cArbiter::run_lcd(lcd);
+}
+
+
+/*********************************************************************
+* @fn                - send_data
+*
+* @brief             - send data from all modules via NRF24
+*
+* @param[in]         - RF24 transmitter instance to transmit over
+* @param[in]         - data to send
+* 
+* @return            - true if the frame was queued
+*
+* @Note              - the target vehicle follows the fleet schedule,
+*                      in slotted mode nothing is sent until the next
+*                      slot is due, the frame is only queued and its
+*                      ack (telemetry) is picked up by RadioTx::service,
+*                      a new command gets full retries until acked,
+*                      the frame carries the downlink ack state of
+*                      the vehicle it goes to. A frame held behind a
+*                      command leaves the imu history for the next one
 *********************************************************************/
-void process_display(LiquidCrystal_I2C& lcd, uint8_t& menu_select, int8_t temp, char data_in[32]) {
+bool send_data(RF24& transmitter, DataPackage& data_pkg) {
+    // vehicle whose slot is due, if any
+    int8_t slot = Fleet::next_slot();
+    if (slot < 0) return false;
+
+    // the command repeats in every frame, only until the vehicle
+    // acked it is it worth the full retries
+    uint8_t menu_select = data_pkg.menu_select;
+    if (menu_select != sending_cmd) {
+        sending_cmd = menu_select;
+        sending_cmd_acks = RetryPolicy::commands_acked();
+    }
+    RetryPolicy::Traffic traffic = RetryPolicy::Traffic::CONTROL;
+
+    // commands are only meant for the active vehicle
+    if (slot != Fleet::active()) {
+        data_pkg.menu_select = static_cast<uint8_t>(CommandCodes::NONE);
+    } else if (menu_select != static_cast<uint8_t>(CommandCodes::NONE) &&
+               RetryPolicy::commands_acked() == sending_cmd_acks) {
+        traffic = RetryPolicy::Traffic::COMMAND;
+    }
+
+    // tells the vehicle which telemetry payloads made it back
+    const Downlink::Decoder& downlink = Fleet::downlink(slot);
+    data_pkg.ack_seq = downlink.ack_seq();
+    data_pkg.ack_bits = downlink.ack_bits();
+
+    data_pkg.tx_stamp = Latency::stamp();
+
+    // only the inputs of the profile go on the air
+    uint8_t frame[max_frame_len + sizeof(MotionBlock)];
+    uint8_t len = pack_frame(data_pkg, frame);
+    if (InputProfile::has(InputProfile::IMU) && Motion::enabled()) {
+        // imu history goes in the unused part of the payload
+        MotionBlock motion;
+        uint8_t motion_len = Motion::pack(motion, data_pkg.tx_stamp);
+        memcpy(frame + len, &motion, motion_len);
+        len += motion_len;
+    }
+    bool queued = RadioTx::send(transmitter, slot, frame, len, traffic);
+    if (queued) {
+        Latency::sending();
+        Motion::sent();
+        Deadline::frame_sent();
+    }
+    data_pkg.menu_select = menu_select;
+    return queued;
+}
+
+// helper functions
+bool read_mpu_6050_data() {
+    Wire.beginTransmission(Mpu6050::device_addr());
+    Wire.write(Mpu6050::start_data_addr());  // starting with register 0x3B (ACCEL_XOUT_H)
+    if (Wire.endTransmission(false) != 0) {
+        Deadline::check_i2c();
+        return false;
+    }
+    // request a total of 14 registers
+    if (Wire.requestFrom(Mpu6050::device_addr(),(uint8_t*)14,(uint8_t*)true) != 14) {
+        Deadline::check_i2c();
+        return false;
+    }
+    mpu_raw.x_acc  = Wire.read()<<8|Wire.read();  // 0x3B (ACCEL_XOUT_H) & 0x3C (ACCEL_XOUT_L)    
+    mpu_raw.y_acc  = Wire.read()<<8|Wire.read();  // 0x3D (ACCEL_YOUT_H) & 0x3E (ACCEL_YOUT_L)
+    mpu_raw.z_acc  = Wire.read()<<8|Wire.read();  // 0x3F (ACCEL_ZOUT_H) & 0x40 (ACCEL_ZOUT_L)
+    mpu_raw.temp   = Wire.read()<<8|Wire.read();  // 0x41 (TEMP_OUT_H) & 0x42 (TEMP_OUT_L)
+    mpu_raw.x_gyro = Wire.read()<<8|Wire.read();  // 0x43 (GYRO_XOUT_H) & 0x44 (GYRO_XOUT_L)
+    mpu_raw.y_gyro = Wire.read()<<8|Wire.read();  // 0x45 (GYRO_YOUT_H) & 0x46 (GYRO_YOUT_L)
+    mpu_raw.z_gyro = Wire.read()<<8|Wire.read();  // 0x47 (GYRO_ZOUT_H) & 0x48 (GYRO_ZOUT_L)
+    return true;
+}
+
+void draw_menu_page(char menu[][16],
+                         int8_t start_item,
+                         int8_t selector_id,
+                         int8_t selector_row,
+                         int8_t custom_char_1_id = -1,
+                         int8_t custom_char_2_id = -1,
+                         int8_t custom_char_3_id = -1,
+                         int8_t custom_char_4_id = -1,
+                         int8_t custom_char_5_id = -1,
+                         int8_t custom_char_6_id = -1) {
+    // pages are drawn into the display buffer, only the cells
+    // that changed are sent to the lcd later on
+    Display::clear();
+
+    // row indicator/select arrow
+    Display::glyph(0, selector_row, selector_id);
+    
+    // item 1
+    Display::print(1, 0, menu[start_item]);
+
+    // custom character 1 item 1
+    if (custom_char_1_id != -1) {
+        Display::glyph(6, 0, custom_char_1_id);
+    }
+    
+    // custom character 2 item 1
+    if (custom_char_2_id != -1) {
+        Display::glyph(12, 0, custom_char_2_id);
+    }
+    
+    // custom character 3 item 1
+    if (custom_char_3_id != -1) {
+        Display::glyph(15, 0, custom_char_3_id);
+    }
+    
+    // item 2
+    if (start_item < 2) {
+        Display::print(1, 1, menu[start_item+1]);
+    }      
+          
+    // custom character 1 item 2
+    if (custom_char_4_id != -1) {
+        Display::glyph(6, 1, custom_char_4_id);
+    }
+    
+    // custom character 2 item 2
+    if (custom_char_5_id != -1) {
+        Display::glyph(12, 1, custom_char_5_id);
+    }
+
+    // custom character 3 item 2
+    if (custom_char_6_id != -1) {
+        Display::glyph(15, 1, custom_char_6_id);
+    }
+}
+
+void vehicle_item_label(uint8_t item, char* buf) {
+    if (item < Fleet::count()) {
+        sprintf_P(buf, fmt_vehicle, item + 1);
+    } else if (item == Fleet::count()) {
+        menu_label(Label::ALL_VEHICLES, buf);
+    } else if (item == Fleet::count() + 1) {
+        menu_label(Fleet::pairing() ? Label::PAIRING : Label::PAIR_NEW, buf);
+    } else {
+        menu_label(Label::BACK, buf);
+    }
+}
+
+void apply_vehicle_item(uint8_t item) {
+    if (item < Fleet::count()) {
+        // drive a single vehicle
+        Fleet::active(item);
+        Fleet::schedule(Fleet::Schedule::SINGLE);
+        Fleet::save();
+    } else if (item == Fleet::count()) {
+        // drive every paired vehicle, one slot each
+        Fleet::schedule(Fleet::Schedule::SLOTTED);
+        Fleet::save();
+    } else if (item == Fleet::count() + 1) {
+        Fleet::request_pair();
+    }
+}
+
+void draw_active_menu(int8_t temp, int8_t data_in[32], bool refresh) {
     //normalize min value
     virtual_pos = (virtual_pos < 0) ? 0 : virtual_pos;
 
@@ -266,54 +458,98 @@ void process_display(LiquidCrystal_I2C& lcd, uint8_t& menu_select, int8_t temp,
         
         // if user has turn knob on rot enc, or it's
         // the first time booting up
-        if (virtual_pos != last_pos || first_time_menu) {
+        if (virtual_pos != last_pos || first_time_menu || refresh) {
             // update active menu
             first_time_menu = false;
             first_time_submenu = true;
             first_time_submenu_options = true;
 
             // normalize max value
-            virtual_pos = (virtual_pos > 4) ? 4 : virtual_pos;
+            virtual_pos = (virtual_pos > 9) ? 9 : virtual_pos;
             
             /********************************* page 1 *********************************/
             if (virtual_pos == 0) {
-                sprintf(curr_page[0], "TX:   %dC   %d", temp, 86);
-                sprintf(curr_page[1], "VEH:  %dC   %d", data_in[0], data_in[1]);        
-                draw_menu_page(lcd, curr_page, 0, Symbols::DOT, 0,
+                sprintf_P(curr_page[0], fmt_tx_status, temp, 86);
+                sprintf_P(curr_page[1], fmt_veh_status, data_in[0], data_in[1]);        
+                draw_menu_page(curr_page, 0, Symbols::DOT, 0,
                     Symbols::THERMOMETER, Symbols::BATTERY, Symbols::PERCENT,
                     Symbols::THERMOMETER, Symbols::BATTERY, Symbols::PERCENT);
                     
             } else if (virtual_pos == 1) {
-                sprintf(curr_page[0], "TX:   %dC   %d", temp, 86);
-                sprintf(curr_page[1], "VEH:  %dC   %d", data_in[0], data_in[1]);
-                draw_menu_page(lcd, curr_page, 0, Symbols::DOT, 1,
+                sprintf_P(curr_page[0], fmt_tx_status, temp, 86);
+                sprintf_P(curr_page[1], fmt_veh_status, data_in[0], data_in[1]);
+                draw_menu_page(curr_page, 0, Symbols::DOT, 1,
                     Symbols::THERMOMETER, Symbols::BATTERY, Symbols::PERCENT,
                     Symbols::THERMOMETER, Symbols::BATTERY, Symbols::PERCENT);
                     
             } 
             /********************************* page 2 *********************************/
             else if (virtual_pos == 2) {
-                sprintf(curr_page[0], "VEH:  %dC   %d", data_in[2], data_in[3]);
-                sprintf(curr_page[1], "VEH:  %dC   %d", data_in[4], data_in[5]);
-                draw_menu_page(lcd, curr_page, 0, Symbols::DOT, 0,
+                sprintf_P(curr_page[0], fmt_veh_status, data_in[2], data_in[3]);
+                sprintf_P(curr_page[1], fmt_veh_status, data_in[4], data_in[5]);
+                draw_menu_page(curr_page, 0, Symbols::DOT, 0,
                     Symbols::THERMOMETER, Symbols::BATTERY, Symbols::PERCENT,
                     Symbols::THERMOMETER, Symbols::BATTERY, Symbols::PERCENT);
                     
             } else if (virtual_pos == 3) {
-                sprintf(curr_page[0], "VEH:  %dC   %d", data_in[2], data_in[3]);
-                sprintf(curr_page[1], "VEH:  %dC   %d", data_in[4], data_in[5]);
-                draw_menu_page(lcd, curr_page, 0, Symbols::DOT, 1,
+                sprintf_P(curr_page[0], fmt_veh_status, data_in[2], data_in[3]);
+                sprintf_P(curr_page[1], fmt_veh_status, data_in[4], data_in[5]);
+                draw_menu_page(curr_page, 0, Symbols::DOT, 1,
                     Symbols::THERMOMETER, Symbols::BATTERY, Symbols::PERCENT,
                     Symbols::THERMOMETER, Symbols::BATTERY, Symbols::PERCENT);
                     
             } 
             /********************************* page 3 *********************************/
             else if (virtual_pos == 4) {
-                sprintf(curr_page[0], "COMMANDS");
-                sprintf(curr_page[1], cmd_msg);
-                draw_menu_page(lcd, curr_page, 0, Symbols::SELECT_ARROW, 0);
+                menu_label(Label::COMMANDS, curr_page[0]);
+                strcpy(curr_page[1], cmd_msg);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 0);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::COMMANDS);                
             }
+            /********************************* page 4 *********************************/
+            else if (virtual_pos == 5) {
+                menu_label(Label::VEHICLES, curr_page[0]);
+                if (Fleet::pairing()) {
+                    menu_label(Label::PAIRING, curr_page[1]);
+                } else if (Fleet::schedule() == Fleet::Schedule::SLOTTED) {
+                    sprintf_P(curr_page[1], fmt_fleet_slotted, Fleet::count());
+                } else {
+                    sprintf_P(curr_page[1], fmt_fleet_single, Fleet::active() + 1);
+                }
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 0);
+                selected_menu = static_cast<uint8_t>(ActiveMenu::VEHICLES);
+            }
+            /********************************* page 5 *********************************/
+            else if (virtual_pos == 6) {
+                menu_label(Label::TRENDS, curr_page[0]);
+                menu_label(Label::EMPTY, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 0);
+                selected_menu = static_cast<uint8_t>(ActiveMenu::TRENDS);
+            }
+            /********************************* page 6 *********************************/
+            else if (virtual_pos == 7) {
+                // free ram now and at its lowest, static data/bss and stack peak
+                snprintf_P(curr_page[0], sizeof(curr_page[0]), fmt_mem_free, Memory::free_now(), Memory::never_used());
+                snprintf_P(curr_page[1], sizeof(curr_page[1]), fmt_mem_static,
+                    Memory::data_size(), Memory::bss_size(), Memory::stack_peak());
+                draw_menu_page(curr_page, 0, Symbols::DOT, 0);
+                selected_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
+            }
+            /********************************* page 7 *********************************/
+            else if (virtual_pos == 8) {
+                menu_label(Label::CALIBRATE_TILT, curr_page[0]);
+                menu_label(Label::EMPTY, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 0);
+                selected_menu = static_cast<uint8_t>(ActiveMenu::CALIBRATE);
+            }
+            /********************************* page 8 *********************************/
+            else if (virtual_pos == 9) {
+                // last loop time and acked frames, follow the tuning live
+                menu_label(Label::TUNING, curr_page[0]);
+                tuning_live_line(curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 0);
+                selected_menu = static_cast<uint8_t>(ActiveMenu::TUNING);
+            }
             last_pos = virtual_pos ;
         }
 
@@ -330,24 +566,24 @@ void process_display(LiquidCrystal_I2C& lcd, uint8_t& menu_select, int8_t temp,
             virtual_pos = (virtual_pos > 3) ? 3 : virtual_pos;
             
             if (virtual_pos == static_cast<int>(Commands::OPERATION_MODE)) {
-                sprintf(curr_page[0], "OPERATION MODE");
-                sprintf(curr_page[1], "RETURN HOME");
-                draw_menu_page(lcd, curr_page, 0, Symbols::SELECT_ARROW, 0);
+                menu_label(Label::OPERATION_MODE, curr_page[0]);
+                menu_label(Label::RETURN_HOME, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 0);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::OPERATION_MODE);
             } else if (virtual_pos == static_cast<int>(Commands::RETURN_HOME)) {
-                sprintf(curr_page[0], "OPERATION MODE");
-                sprintf(curr_page[1], "RETURN HOME");
-                draw_menu_page(lcd, curr_page, 0, Symbols::SELECT_ARROW, 1);
+                menu_label(Label::OPERATION_MODE, curr_page[0]);
+                menu_label(Label::RETURN_HOME, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 1);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::RETURN_HOME);
             } else if (virtual_pos == static_cast<int>(Commands::LIGHTS)) {
-                sprintf(curr_page[0], "LIGHTS");
-                sprintf(curr_page[1], "BACK");
-                draw_menu_page(lcd, curr_page, 0, Symbols::SELECT_ARROW, 0);
+                menu_label(Label::LIGHTS, curr_page[0]);
+                menu_label(Label::BACK, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 0);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::LIGHTS);
             } else if (virtual_pos == static_cast<int>(Commands::CANCEL)) {
-                sprintf(curr_page[0], "LIGHTS");
-                sprintf(curr_page[1], "BACK");
-                draw_menu_page(lcd, curr_page, 0, Symbols::BACK_ARROW, 1);
+                menu_label(Label::LIGHTS, curr_page[0]);
+                menu_label(Label::BACK, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::BACK_ARROW, 1);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
             }
             last_pos = virtual_pos ;
@@ -366,21 +602,21 @@ void process_display(LiquidCrystal_I2C& lcd, uint8_t& menu_select, int8_t temp,
             virtual_pos = (virtual_pos > 2) ? 2 : virtual_pos;
 
             if (virtual_pos == static_cast<int>(OperationMode::MANUAL)) {
-                sprintf(curr_page[0], "MANUAL");
-                sprintf(curr_page[1], "AUTO");
-                draw_menu_page(lcd, curr_page, 0, Symbols::SELECT_ARROW, 0);
+                menu_label(Label::MANUAL, curr_page[0]);
+                menu_label(Label::AUTO, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 0);
                 selected_option = static_cast<uint8_t>(CommandCodes::OP_MANUAL);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
             } else if (virtual_pos == static_cast<int>(OperationMode::AUTO)) {
-                sprintf(curr_page[0], "MANUAL");
-                sprintf(curr_page[1], "AUTO");
-                draw_menu_page(lcd, curr_page, 0, Symbols::SELECT_ARROW, 1);
+                menu_label(Label::MANUAL, curr_page[0]);
+                menu_label(Label::AUTO, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 1);
                 selected_option = static_cast<uint8_t>(CommandCodes::OP_AUTO);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
             } else if (virtual_pos == static_cast<int>(OperationMode::CANCEL)) {
-                sprintf(curr_page[0], "BACK");
-                sprintf(curr_page[1], "");
-                draw_menu_page(lcd, curr_page, 0, Symbols::BACK_ARROW, 0);
+                menu_label(Label::BACK, curr_page[0]);
+                menu_label(Label::EMPTY, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::BACK_ARROW, 0);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::COMMANDS); 
                 selected_option = static_cast<uint8_t>(CommandCodes::NONE);
             }
@@ -400,15 +636,15 @@ void process_display(LiquidCrystal_I2C& lcd, uint8_t& menu_select, int8_t temp,
             virtual_pos = (virtual_pos > 1) ? 1 : virtual_pos;
 
             if (virtual_pos == static_cast<int>(ReturnHome::CONFIRM)) {
-                sprintf(curr_page[0], "CONFIRM");
-                sprintf(curr_page[1], "BACK");
-                draw_menu_page(lcd, curr_page, 0, Symbols::SELECT_ARROW, 0);
+                menu_label(Label::CONFIRM, curr_page[0]);
+                menu_label(Label::BACK, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 0);
                 selected_option = static_cast<uint8_t>(CommandCodes::RET_HOME);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
             } else if (virtual_pos == static_cast<int>(ReturnHome::CANCEL)) {
-                sprintf(curr_page[0], "CONFIRM");
-                sprintf(curr_page[1], "BACK");
-                draw_menu_page(lcd, curr_page, 0, Symbols::BACK_ARROW, 1);
+                menu_label(Label::CONFIRM, curr_page[0]);
+                menu_label(Label::BACK, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::BACK_ARROW, 1);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::COMMANDS);
                 selected_option = static_cast<uint8_t>(CommandCodes::NONE);
             }
@@ -428,27 +664,27 @@ void process_display(LiquidCrystal_I2C& lcd, uint8_t& menu_select, int8_t temp,
             virtual_pos = (virtual_pos > 3) ? 3 : virtual_pos;
 
             if (virtual_pos == static_cast<int>(Lights::ON)) {
-                sprintf(curr_page[0], "ON");
-                sprintf(curr_page[1], "OFF");
-                draw_menu_page(lcd, curr_page, 0, Symbols::SELECT_ARROW, 0);
+                menu_label(Label::ON, curr_page[0]);
+                menu_label(Label::OFF, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 0);
                 selected_option = static_cast<uint8_t>(CommandCodes::LIGHTS_ON);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
             } else if (virtual_pos == static_cast<int>(Lights::OFF)) {
-                sprintf(curr_page[0], "ON");
-                sprintf(curr_page[1], "OFF");
-                draw_menu_page(lcd, curr_page, 0, Symbols::SELECT_ARROW, 1);
+                menu_label(Label::ON, curr_page[0]);
+                menu_label(Label::OFF, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 1);
                 selected_option = static_cast<uint8_t>(CommandCodes::LIGHTS_OFF);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
             } else if (virtual_pos == static_cast<int>(Lights::AUTO)) {
-                sprintf(curr_page[0], "AUTO");
-                sprintf(curr_page[1], "BACK");
-                draw_menu_page(lcd, curr_page, 0, Symbols::SELECT_ARROW, 0);
+                menu_label(Label::AUTO, curr_page[0]);
+                menu_label(Label::BACK, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::SELECT_ARROW, 0);
                 selected_option = static_cast<uint8_t>(CommandCodes::LIGHTS_AUTO);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
             } else if (virtual_pos == static_cast<int>(Lights::CANCEL)) {
-                sprintf(curr_page[0], "AUTO");
-                sprintf(curr_page[1], "BACK");
-                draw_menu_page(lcd, curr_page, 0, Symbols::BACK_ARROW, 1);
+                menu_label(Label::AUTO, curr_page[0]);
+                menu_label(Label::BACK, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::BACK_ARROW, 1);
                 selected_menu = static_cast<uint8_t>(ActiveMenu::COMMANDS);
                 selected_option = static_cast<uint8_t>(CommandCodes::NONE);
             }
@@ -456,172 +692,249 @@ void process_display(LiquidCrystal_I2C& lcd, uint8_t& menu_select, int8_t temp,
         }
     }
 
-    // option selected
-    if ((!digitalRead(re_sw_pin))) {
-        // navigate to selected menu
-        curr_menu = selected_menu;
+    /*************************** vehicles submenu ***************************/
+    else if (curr_menu == static_cast<uint8_t>(ActiveMenu::VEHICLES)) {
+        if (virtual_pos != last_pos || first_time_submenu) {
+            // update current active menu
+            first_time_menu = true;
+            first_time_submenu = false;
+            first_time_submenu_options = true;
+
+            // one item per vehicle, then all (slotted), pair new and back
+            uint8_t back_item = Fleet::count() + 2;
 
-        // update command selection (0 if nothing was selected)
-        menu_select = selected_option;
+            // normalize max value
+            virtual_pos = (virtual_pos > back_item) ? back_item : virtual_pos;
+
+            // two items per page
+            uint8_t first_item = virtual_pos & ~1;
+            vehicle_item_label(first_item, curr_page[0]);
+            if (first_item + 1 <= back_item) {
+                vehicle_item_label(first_item + 1, curr_page[1]);
+            } else {
+                menu_label(Label::EMPTY, curr_page[1]);
+            }
 
-        // if command was sent, navigate to message page
-        if (menu_select != 0) {
-            virtual_pos = 4;
-        } 
-        // reset rot enc position
-        else {
-            virtual_pos = 0;
+            int8_t selector = (virtual_pos == back_item) ? Symbols::BACK_ARROW : Symbols::SELECT_ARROW;
+            draw_menu_page(curr_page, 0, selector, virtual_pos & 1);
+            selected_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
+            selected_vehicle_item = virtual_pos;
+            last_pos = virtual_pos ;
         }
-        // msg to be displayed if a command was sent (blank if no cmd)
-        memcpy(cmd_msg, command_msgs[selected_option], sizeof(cmd_msg));
+    }
 
-        // wait to prevent debouncing
-        while (!digitalRead(re_sw_pin)) {
-          delay(10);
+    /**************************** trends submenu ****************************/
+    else if (curr_menu == static_cast<uint8_t>(ActiveMenu::TRENDS)) {
+        if (virtual_pos != last_pos || first_time_submenu || refresh) {
+            // update current active menu
+            first_time_menu = true;
+            first_time_submenu = false;
+            first_time_submenu_options = true;
+
+            // one page per telemetry channel, then back
+            uint8_t back_item = static_cast<uint8_t>(Telemetry::Channel::CHANNEL_COUNT);
+
+            // normalize max value
+            virtual_pos = (virtual_pos > back_item) ? back_item : virtual_pos;
+
+            if (virtual_pos == back_item) {
+                menu_label(Label::BACK, curr_page[0]);
+                menu_label(Label::EMPTY, curr_page[1]);
+                draw_menu_page(curr_page, 0, Symbols::BACK_ARROW, 0);
+            } else {
+                TrendView::show(virtual_pos);
+            }
+            selected_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
+            last_pos = virtual_pos ;
         }
     }
-}
 
+    /**************************** tuning submenu ****************************/
+    else if (curr_menu == static_cast<uint8_t>(ActiveMenu::TUNING)) {
+        if (virtual_pos != last_pos || first_time_submenu || refresh) {
+            // update current active menu
+            first_time_menu = true;
+            first_time_submenu = false;
+            first_time_submenu_options = true;
 
-/*********************************************************************
-* @fn                - send_data
-*
-* @brief             - send data from all modules via NRF24
-*
-* @param[in]         - RF24 transmitter instance to transmit over
-* @param[in]         - data to send
-* 
-* @return            - none
-*
-* @Note              - none
-*********************************************************************/
-void send_data(RF24& transmitter, DataPackage& data_pkg) {
-    transmitter.write(&data_pkg, sizeof(data_pkg));
-}
+            // one item per parameter, then save and back
+            uint8_t back_item = Tuning::param_count + 1;
 
-// helper functions
-void read_mpu_6050_data() {
-    Wire.beginTransmission(Mpu6050::device_addr());
-    Wire.write(Mpu6050::start_data_addr());  // starting with register 0x3B (ACCEL_XOUT_H)
-    Wire.endTransmission(false);
-    Wire.requestFrom(Mpu6050::device_addr(),(uint8_t*)14,(uint8_t*)true);  // request a total of 14 registers
-    raw_x_acc  = Wire.read()<<8|Wire.read();  // 0x3B (ACCEL_XOUT_H) & 0x3C (ACCEL_XOUT_L)    
-    raw_y_acc  = Wire.read()<<8|Wire.read();  // 0x3D (ACCEL_YOUT_H) & 0x3E (ACCEL_YOUT_L)
-    raw_z_acc  = Wire.read()<<8|Wire.read();  // 0x3F (ACCEL_ZOUT_H) & 0x40 (ACCEL_ZOUT_L)
-    raw_temp   = Wire.read()<<8|Wire.read();  // 0x41 (TEMP_OUT_H) & 0x42 (TEMP_OUT_L)
-    raw_x_gyro = Wire.read()<<8|Wire.read();  // 0x43 (GYRO_XOUT_H) & 0x44 (GYRO_XOUT_L)
-    raw_y_gyro = Wire.read()<<8|Wire.read();  // 0x45 (GYRO_YOUT_H) & 0x46 (GYRO_YOUT_L)
-    raw_z_gyro = Wire.read()<<8|Wire.read();  // 0x47 (GYRO_ZOUT_H) & 0x48 (GYRO_ZOUT_L)
-}
+            // normalize max value
+            virtual_pos = (virtual_pos > back_item) ? back_item : virtual_pos;
 
-int16_t get_calibrated_x_acc() {
-    // ignore oscillating values within the min_x_acc and max_x_acc range
-    // as this is a range of values that will be present, even when the 
-    // mpu is not moving
-    if (raw_x_acc >= Mpu6050::min_x_acc() && raw_x_acc <= Mpu6050::max_x_acc()) return 0;
-
-    // if the min and max values are outside of the pre-determined
-    // range, return the the max pwm values
-    if (raw_x_acc < Mpu6050::lower_boundary()) return pwm_x_val * -1;
-    if (raw_x_acc > Mpu6050::upper_boundary()) return pwm_x_val;
-
-    // if the raw value is less than the min_x_acc
-    // the mpu has been tilted to the left, in this case
-    // represented as a negative value ranging from -1 to -255
-    int8_t sign = (raw_x_acc < Mpu6050::min_x_acc()) ? -1 : 1;
-
-    /* map input data to values according to the following:
-    *     left/down: -1 to -255
-    *     down/up:    1 to  255
-    *     neutral:    0
-    */     
-    return map(raw_x_acc, Mpu6050::min_x_acc(), (sign*Mpu6050::upper_boundary()), 0, (sign*pwm_x_val)); 
+            draw_tuning_item(virtual_pos);
+            selected_menu = (virtual_pos == back_item) ?
+                static_cast<uint8_t>(ActiveMenu::MAIN_MENU) : static_cast<uint8_t>(ActiveMenu::TUNING);
+            selected_tuning_item = virtual_pos;
+            last_pos = virtual_pos ;
+        }
+    }
 }
 
-int16_t get_calibrated_y_acc() {
-    // ignore oscillating values within the min_y_acc and max_y_acc range
-    // as this is a range of values that will be present, even when the 
-    // mpu is not moving
-    if (raw_y_acc >= Mpu6050::min_y_acc() && raw_y_acc <= Mpu6050::max_y_acc()) return 0;
-
-    // if the min and max values are outside of the pre-determined
-    // range, return the the max down/up pwm values
-    if (raw_y_acc < Mpu6050::lower_boundary()) return pwm_y_val * -1;
-    if (raw_y_acc > Mpu6050::upper_boundary()) return pwm_y_val;
-
-    // if the raw value is less than the min_x_acc
-    // the mpu has been tilted to the left, in this case
-    // represented as a negative value ranging from -1 to -255
-    int8_t sign = (raw_y_acc < Mpu6050::min_y_acc()) ? -1 : 1;
-
-    /* map input data to values according to the following:
-    *     left/down: -1 to -255
-    *     down/up:    1 to  255
-    *     neutral:    0
-    */     
-    return map(raw_y_acc, Mpu6050::min_y_acc(), (sign*Mpu6050::upper_boundary()), 0, (sign*pwm_y_val)); 
-}
+void select_option(uint8_t& menu_select) {
+    // vehicle selection/pairing is handled locally, nothing is sent
+    if (curr_menu == static_cast<uint8_t>(ActiveMenu::VEHICLES)) {
+        apply_vehicle_item(selected_vehicle_item);
+    }
 
-void draw_menu_page(LiquidCrystal_I2C& lcd, char menu[][16],
-                         int8_t start_item,
-                         int8_t selector_id,
-                         int8_t selector_row,
-                         int8_t custom_char_1_id = -1,
-                         int8_t custom_char_2_id = -1,
-                         int8_t custom_char_3_id = -1,
-                         int8_t custom_char_4_id = -1,
-                         int8_t custom_char_5_id = -1,
-                         int8_t custom_char_6_id = -1) {
-    // clear the screen
-    lcd.clear();
+    // the tuning page keeps its place, a press starts/stops editing
+    // the highlighted parameter or stores the profile
+    if (curr_menu == static_cast<uint8_t>(ActiveMenu::TUNING) &&
+        selected_menu == static_cast<uint8_t>(ActiveMenu::TUNING)) {
+        if (selected_tuning_item < Tuning::param_count) {
+            tuning_edit = !tuning_edit;
+        } else {
+            Tuning::save();
+        }
+        first_time_submenu = true;
+        return;
+    }
 
-    // row indicator/select arrow
-    lcd.setCursor(0, selector_row);
-    lcd.write(selector_id);
-    
-    // item 1
-    lcd.setCursor(1, 0);
-    lcd.print(menu[start_item]);
+    // navigate to selected menu
+    curr_menu = selected_menu;
 
-    // custom character 1 item 1
-    if (custom_char_1_id != -1) {
-        lcd.setCursor(6, 0);
-        lcd.write(custom_char_1_id);
-    }
-    
-    // custom character 2 item 1
-    if (custom_char_2_id != -1) {
-        lcd.setCursor(12, 0);
-        lcd.write(custom_char_2_id);
+    // update command selection (0 if nothing was selected)
+    menu_select = selected_option;
+
+    // if command was sent, navigate to message page
+    if (menu_select != 0) {
+        virtual_pos = 4;
+    } 
+    // reset rot enc position
+    else {
+        virtual_pos = 0;
     }
-    
-    // custom character 3 item 1
-    if (custom_char_3_id != -1) {
-        lcd.setCursor(15, 0);
-        lcd.write(custom_char_3_id);
+    // msg to be displayed if a command was sent (blank if no cmd)
+    command_msg(selected_option, cmd_msg);
+    if (menu_select != 0) PT_INIT(&cmd_msg_pt);
+
+    // calibration runs as a flow, the menus wait until it is done
+    if (curr_menu == static_cast<uint8_t>(ActiveMenu::CALIBRATE)) {
+        calibrate_cancel = false;
+        PT_INIT(&calibrate_pt);
     }
-    
-    // item 2
-    if (start_item < 2) {
-        lcd.setCursor(1, 1);
-        lcd.print(menu[start_item+1]);
-    }      
-          
-    // custom character 1 item 2
-    if (custom_char_4_id != -1) {
-        lcd.setCursor(6, 1);
-        lcd.write(custom_char_4_id);
+}
+
+void draw_labels(Label row_1, Label row_2) {
+    char buf[16];
+    Display::clear();
+    menu_label(row_1, buf);
+    Display::print(1, 0, buf);
+    menu_label(row_2, buf);
+    Display::print(1, 1, buf);
+}
+
+void tuning_live_line(char* buf) {
+    uint16_t queued = RadioTx::queued();
+    uint16_t acked_pct = queued ? (uint32_t)RadioTx::acked() * 100 / queued : 0;
+    snprintf_P(buf, 16, fmt_tuning_live, Deadline::last_iteration_us(), acked_pct);
+}
+
+void draw_tuning_item(uint8_t item) {
+    char curr_page[2][16];
+    int8_t selector = Symbols::SELECT_ARROW;
+
+    if (item < Tuning::param_count) {
+        // name and value, the live line shows what the change did
+        Tuning::Param p = static_cast<Tuning::Param>(item);
+        char name[16];
+        Tuning::name(p, name);
+        snprintf_P(curr_page[0], sizeof(curr_page[0]), fmt_tuning_value, name, Tuning::value(p));
+        tuning_live_line(curr_page[1]);
+        if (tuning_edit) selector = Symbols::DOT;
+    } else if (item == Tuning::param_count) {
+        menu_label(Label::SAVE_PROFILE, curr_page[0]);
+        menu_label(Tuning::saved() ? Label::SAVED : Label::NOT_SAVED, curr_page[1]);
+    } else {
+        menu_label(Label::BACK, curr_page[0]);
+        menu_label(Label::EMPTY, curr_page[1]);
+        selector = Symbols::BACK_ARROW;
     }
-    
-    // custom character 2 item 2
-    if (custom_char_5_id != -1) {
-        lcd.setCursor(12, 1);
-        lcd.write(custom_char_5_id);
+    draw_menu_page(curr_page, 0, selector, 0);
+}
+
+/*********************************************************************
+* @fn                - cmd_msg_flow
+*
+* @brief             - clears the command message after a while
+*
+* @param[in]         - flow state
+*
+* @return            - ENDED once the message is gone
+*
+* @Note              - restarted by every command sent, the command
+*                      itself keeps going out with each frame
+*********************************************************************/
+PtState cmd_msg_flow(Pt* pt) {
+    PT_BEGIN(pt);
+    PT_SLEEP(pt, cmd_msg_ms);
+    cmd_msg[0] = '\0';
+    Events::post_refresh();
+    PT_END(pt);
+}
+
+/*********************************************************************
+* @fn                - calibrate_flow
+*
+* @brief             - measures the resting tilt range again
+*
+* @param[in]         - flow state
+*
+* @return            - ENDED when back on the main menu
+*
+* @Note              - same as the boot calibration, but it yields
+*                      between samples so the vehicle keeps getting
+*                      frames. The arbiter reads the imu far less often
+*                      than the loop runs, only new samples are counted.
+*                      The new range only applies at the end
+*********************************************************************/
+PtState calibrate_flow(Pt* pt) {
+    static int16_t min_x, max_x, min_y, max_y;
+    static uint8_t taken, seen;
+
+    PT_BEGIN(pt);
+    draw_labels(Label::HOLD_STILL, Label::PRESS_TO_CANCEL);
+
+    // no mpu-6050 samples without tilt in the input profile
+    if (!InputProfile::has(InputProfile::IMU)) calibrate_cancel = true;
+
+    // let the hand settle after the press
+    PT_SLEEP_UNTIL(pt, 1000, calibrate_cancel);
+
+    min_x = min_y = INT16_MAX;
+    max_x = max_y = INT16_MIN;
+    seen = mpu_raw_seq;
+    for (taken = 0; taken < calibrate_samples && !calibrate_cancel; ) {
+        PT_YIELD(pt);
+        if (mpu_raw_seq == seen) continue;
+        seen = mpu_raw_seq;
+
+        min_x = min(min_x, mpu_raw.x_acc);
+        max_x = max(max_x, mpu_raw.x_acc);
+        min_y = min(min_y, mpu_raw.y_acc);
+        max_y = max(max_y, mpu_raw.y_acc);
+        ++taken;
     }
-    Serial.print("custom_char_6_id: "); Serial.println(custom_char_6_id);
-    // custom character 3 item 2
-    if (custom_char_6_id != -1) {
-        lcd.setCursor(15, 1);
-        lcd.write(custom_char_6_id);   
+
+    if (calibrate_cancel) {
+        draw_labels(Label::CALIBRATE_TILT, Label::CANCELLED);
+    } else {
+        // the control isr reads the range, it must not see half of it
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            Mpu6050::min_x_acc(min_x - acc_buffer);
+            Mpu6050::max_x_acc(max_x + acc_buffer);
+            Mpu6050::min_y_acc(min_y - acc_buffer);
+            Mpu6050::max_y_acc(max_y + acc_buffer);
+        }
+        draw_labels(Label::CALIBRATE_TILT, Label::CALIBRATED);
     }
+    PT_SLEEP(pt, 1000);
+
+    // back to where the flow was started from
+    curr_menu = static_cast<uint8_t>(ActiveMenu::MAIN_MENU);
+    first_time_menu = true;
+    virtual_pos = 8;
+    Events::post_refresh();
+    PT_END(pt);
 }
@@ -16,9 +16,10 @@
 
 void process_joystick(Joystick& j);
 void process_joystick_alt(Joystick& j);
-void process_mpu_6050(Mpu6050::Instance& mpu);
+void process_mpu_6050(Mpu6050::Instance& mpu, const Mpu6050::RawData* raw);
+void sample_mpu_6050();
 
 void process_display(LiquidCrystal_I2C& lcd, uint8_t& menu_select, int8_t temp, bool& init_boot);
-void send_data(RF24& transmitter, DataPackage& data_pkg);
+bool send_data(RF24& transmitter, DataPackage& data_pkg);
 
-void process_display(LiquidCrystal_I2C& lcd, uint8_t& menu_select, int8_t temp, char data_in[32]);
+void process_display(LiquidCrystal_I2C& lcd, uint8_t& menu_select, int8_t temp, int8_t data_in[32]);
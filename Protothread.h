@@ -0,0 +1,77 @@
+/**
+ * @file Protothread.h
+ *
+ * @brief Stackless coroutines (protothreads) for flows that wait on
+ *        events or timeouts without blocking the control loop
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include "Arduino.h"
+
+/*
+ * A flow is a function taking a Pt* and returning PtState, its body
+ * sits between PT_BEGIN and PT_END. Waiting returns to the caller and
+ * the next call resumes right after the wait, so:
+ *   - locals do not survive a wait, keep state in statics
+ *   - waits can not be used inside a switch statement
+ *   - two waits can not share a source line
+ */
+
+enum class PtState : uint8_t {
+    WAITING,
+    ENDED
+};
+
+// 4 bytes per flow: where to resume, and when the last sleep started
+struct Pt {
+    uint16_t lc;
+    uint16_t mark_ms;
+
+    Pt() : lc(0xFFFF), mark_ms(0) {}
+};
+
+// a flow that ended (or never started) skips its body
+const uint16_t pt_ended = 0xFFFF;
+
+#define PT_INIT(pt)         do { (pt)->lc = 0; } while (0)
+#define PT_RUNNING(pt)      ((pt)->lc != pt_ended)
+
+#define PT_BEGIN(pt)        switch ((pt)->lc) { case 0:
+
+#define PT_WAIT_UNTIL(pt, cond)                         \
+    do {                                                \
+        (pt)->lc = __LINE__; case __LINE__:             \
+        if (!(cond)) return PtState::WAITING;           \
+    } while (0)
+
+#define PT_YIELD(pt)                                    \
+    do {                                                \
+        (pt)->lc = __LINE__;                            \
+        return PtState::WAITING; case __LINE__:;        \
+    } while (0)
+
+// millis truncated to 16 bits, sleeps up to about a minute
+#define PT_SLEEP(pt, ms)                                \
+    do {                                                \
+        (pt)->mark_ms = millis();                       \
+        PT_WAIT_UNTIL(pt, static_cast<uint16_t>(millis() - (pt)->mark_ms) >= (ms)); \
+    } while (0)
+
+// same as PT_SLEEP, cut short when cond holds
+#define PT_SLEEP_UNTIL(pt, ms, cond)                    \
+    do {                                                \
+        (pt)->mark_ms = millis();                       \
+        PT_WAIT_UNTIL(pt, (cond) || static_cast<uint16_t>(millis() - (pt)->mark_ms) >= (ms)); \
+    } while (0)
+
+#define PT_EXIT(pt)                                     \
+    do {                                                \
+        (pt)->lc = pt_ended;                            \
+        return PtState::ENDED;                          \
+    } while (0)
+
+#define PT_END(pt)          } (pt)->lc = pt_ended; return PtState::ENDED
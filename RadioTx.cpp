@@ -0,0 +1,225 @@
+/**
+ * @file RadioTx.cpp
+ *
+ * @brief Non-blocking radio transmit path definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "RadioTx.h"
+#include "Fleet.h"
+#include "Trace.h"
+#include "Board.h"
+
+// the external interrupt pins are taken by the rotary encoder, the
+// irq (active low) comes in on a pin change interrupt instead
+static_assert(Board::RadioIrq::port == Board::port_b, "radio irq must be on PCINT0");
+
+namespace RadioTx {
+    // with the default retries a frame is done well before this, if the
+    // irq did not show up by then the status register is read anyway
+    const uint32_t irq_timeout_us = 40000;
+
+    // counters
+    uint16_t _queued = 0;
+    uint16_t _acked = 0;
+    uint16_t _failed = 0;
+    uint16_t _replaced = 0;
+    uint16_t _held = 0;
+    uint16_t _irq_timeouts = 0;
+    Histogram _air_time;
+
+    // frame in the tx fifo, only the newest one is ever kept
+    bool _in_flight = false;
+    uint8_t _slot = 0;
+    RetryPolicy::Traffic _traffic = RetryPolicy::Traffic::CONTROL;
+    unsigned long _queued_us = 0;
+
+    // set by the irq isr, everything else happens in the loop
+    volatile bool _irq = false;
+    volatile unsigned long _irq_us = 0;
+
+    /********* counters api *********/
+    uint16_t queued() {
+        return _queued;
+    }
+
+    uint16_t acked() {
+        return _acked;
+    }
+
+    uint16_t failed() {
+        return _failed;
+    }
+
+    uint16_t replaced() {
+        return _replaced;
+    }
+
+    uint16_t held() {
+        return _held;
+    }
+
+    uint16_t irq_timeouts() {
+        return _irq_timeouts;
+    }
+
+    const Histogram& air_time() {
+        return _air_time;
+    }
+
+    // starts the counters over, e.g. after a tuning change
+    void reset() {
+        _queued = 0;
+        _acked = 0;
+        _failed = 0;
+        _replaced = 0;
+        _held = 0;
+        _irq_timeouts = 0;
+        _air_time.clear();
+    }
+
+    /*********************************************************************
+    * @fn                - config_tx
+    *
+    * @brief             - routes tx done and max retries to the irq pin
+    *
+    * @param[in]         - reference to radio object (RF24)
+    *
+    * @return            - none
+    *
+    * @Note              - ack payloads arrive together with tx done, so
+    *                      rx ready stays masked
+    *********************************************************************/
+    void config_tx(RF24& radio) {
+        Board::RadioIrq::input();
+        radio.maskIRQ(false, false, true);
+        Board::RadioIrq::enable_pcint();
+
+        Serial.println(F("    Radio tx config complete!"));
+    }
+
+    bool idle() {
+        return !_in_flight;
+    }
+
+    /*********************************************************************
+    * @fn                - send
+    *
+    * @brief             - queues a frame and returns right away
+    *
+    * @param[in]         - reference to radio object (RF24)
+    * @param[in]         - vehicle index the frame goes to
+    * @param[in]         - frame
+    * @param[in]         - frame length
+    * @param[in]         - kind of frame, sets its retries
+    *
+    * @return            - false if the frame could not be queued
+    *
+    * @Note              - every frame is a full snapshot of the inputs,
+    *                      so a control frame still waiting for its ack
+    *                      is stale and gets replaced instead of queued
+    *                      behind. A command or a pairing probe keeps its
+    *                      full retries, the frames sent meanwhile are
+    *                      dropped (held), the next ones repeat the
+    *                      command byte anyway
+    *********************************************************************/
+    bool send(RF24& radio, uint8_t slot, const void* frame, uint8_t len,
+              RetryPolicy::Traffic traffic) {
+        // pick up a completion that is already there
+        service(radio);
+
+        if (_in_flight && _traffic != RetryPolicy::Traffic::CONTROL) {
+            ++_held;
+            return false;
+        }
+        if (_in_flight) {
+            radio.flush_tx();
+            Trace::record(Trace::Event::TX_REPLACED);
+            ++_replaced;
+            _in_flight = false;
+        }
+
+        // the fifo is empty, safe to point the pipe somewhere else
+        Fleet::open_slot(radio, slot);
+        RetryPolicy::apply(radio, traffic, len);
+        if (!radio.writeFast(frame, len)) return false;
+
+        Trace::record(Trace::Event::TX_QUEUED, slot);
+        _in_flight = true;
+        _slot = slot;
+        _traffic = traffic;
+        _queued_us = micros();
+        ++_queued;
+        return true;
+    }
+
+    /*********************************************************************
+    * @fn                - service
+    *
+    * @brief             - handles what the irq reported
+    *
+    * @param[in]         - reference to radio object (RF24)
+    *
+    * @return            - none
+    *
+    * @Note              - a single flag check when nothing happened,
+    *                      the ack payload goes to the fleet telemetry
+    *********************************************************************/
+    void service(RF24& radio) {
+        bool timed_out = false;
+        if (!_irq) {
+            if (!_in_flight || micros() - _queued_us < irq_timeout_us) return;
+            timed_out = true;
+            ++_irq_timeouts;
+        }
+
+        noInterrupts();
+        _irq = false;
+        unsigned long irq_us = _irq_us;
+        interrupts();
+
+        bool tx_ok, tx_fail, rx_ready;
+        radio.whatHappened(tx_ok, tx_fail, rx_ready);
+
+        // no answer at all, give the frame up so the fifo is usable
+        if (timed_out && !tx_ok) tx_fail = true;
+
+        if (tx_fail) {
+            // max retries, the frame is still at the head of the fifo
+            radio.flush_tx();
+            Trace::record(Trace::Event::TX_FAILED);
+            ++_failed;
+            if (_in_flight) RetryPolicy::failed(_traffic);
+            _in_flight = false;
+        }
+        if (tx_ok) {
+            Trace::record(Trace::Event::TX_ACKED);
+            ++_acked;
+            if (_in_flight && !timed_out) _air_time.add(irq_us - _queued_us);
+            if (_in_flight) RetryPolicy::acked(radio.getARC(), _traffic);
+            _in_flight = false;
+            Fleet::store_ack(radio, _slot, static_cast<uint16_t>(irq_us >> 2), !timed_out);
+        }
+    }
+
+    void print() {
+        Serial.print(F("tx: queued="));   Serial.print(_queued);
+        Serial.print(F(" acked="));       Serial.print(_acked);
+        Serial.print(F(" failed="));      Serial.print(_failed);
+        Serial.print(F(" replaced="));    Serial.print(_replaced);
+        Serial.print(F(" held="));        Serial.print(_held);
+        Serial.print(F(" irq timeouts=")); Serial.println(_irq_timeouts);
+        _air_time.print(F("tx air"));
+    }
+}
+
+// nRF24 irq, the spi bus may be busy in the loop so only flag it
+ISR(PCINT0_vect) {
+    if (!Board::RadioIrq::read()) {
+        RadioTx::_irq_us = micros();
+        RadioTx::_irq = true;
+        Trace::record(Trace::Event::RADIO_IRQ);
+    }
+}
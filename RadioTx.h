@@ -0,0 +1,36 @@
+/**
+ * @file RadioTx.h
+ *
+ * @brief Non-blocking radio transmit path, frames are queued in the
+ *        nRF24 tx fifo and completion comes back on the irq pin
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <RF24.h>
+#include "Histogram.h"
+#include "RetryPolicy.h"
+
+namespace RadioTx {
+    /********* counters api *********/
+    uint16_t queued();
+    uint16_t acked();
+    uint16_t failed();
+    uint16_t replaced();
+    uint16_t held();
+    uint16_t irq_timeouts();
+    const Histogram& air_time();
+    void reset();
+
+    // utility functions
+    void config_tx(RF24& radio);
+    bool idle();
+    bool send(RF24& radio, uint8_t slot, const void* frame, uint8_t len,
+              RetryPolicy::Traffic traffic = RetryPolicy::Traffic::CONTROL);
+    void service(RF24& radio);
+
+    void print();
+}
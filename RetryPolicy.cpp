@@ -0,0 +1,189 @@
+/**
+ * @file RetryPolicy.cpp
+ *
+ * @brief Adaptive nRF24 auto-retry count and delay definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "RetryPolicy.h"
+#include "Control.h"
+#include "DataPackage.h"
+
+namespace RetryPolicy {
+    // pll settling before every transmit and every receive
+    const uint16_t settle_us = 130;
+
+    // slack on top of the ack air time before a retry is started
+    const uint16_t margin_us = 50;
+
+    // control retries start here, then follow the link
+    const uint8_t initial_retries = 3;
+
+    // acks in a row with few retries before the count is lowered
+    const uint8_t calm_acks = 8;
+
+    // retry delay (ARD), (code + 1) * 250us, long enough for the ack
+    // payload at the configured data rate
+    rf24_datarate_e _rate = RF24_1MBPS;
+    uint8_t _delay_code = 0;
+
+    // control frame retries, capped by the budget, the attempts that
+    // fit before the next control frame replaces the current one
+    uint8_t _control_retries = initial_retries;
+    uint8_t _budget = max_retries;
+    uint8_t _budget_len = 0;
+    uint8_t _budget_period_ms = 0;
+
+    // mean retries per acked frame, Q4, and acks since the last change
+    int16_t _arc_avg_x16 = 0;
+    uint8_t _calm = 0;
+
+    // counters
+    uint16_t _commands_acked = 0;
+    uint16_t _commands_lost = 0;
+    uint16_t _controls_lost = 0;
+
+    // last value written to SETUP_RETR, the spi write is skipped when
+    // nothing changed
+    uint16_t _written = 0xFFFF;
+
+    // helper functions prototypes
+    uint16_t air_us(uint8_t bytes);
+    uint8_t budget_for(uint8_t len);
+
+    /********* state api *********/
+    uint8_t control_retries() {
+        return _control_retries;
+    }
+
+    uint8_t retry_budget() {
+        return _budget;
+    }
+
+    uint16_t delay_us() {
+        return (_delay_code + 1) * 250;
+    }
+
+    uint16_t commands_acked() {
+        return _commands_acked;
+    }
+
+    /*********************************************************************
+    * @fn                - config_retries
+    *
+    * @brief             - sizes the retry delay for the data rate
+    *
+    * @param[in]         - reference to radio object (RF24)
+    *
+    * @return            - none
+    *
+    * @Note              - every ack carries a full AckPackage, a shorter
+    *                      delay would retry before the ack is received
+    *********************************************************************/
+    void config_retries(RF24& radio) {
+        _rate = radio.getDataRate();
+        uint16_t ack_us = settle_us + air_us(sizeof(AckPackage)) + margin_us;
+        _delay_code = min((ack_us + 249) / 250 - 1, 15);
+        _written = 0xFFFF;
+
+        Serial.println(F("    Retry policy config complete!"));
+    }
+
+    /*********************************************************************
+    * @fn                - apply
+    *
+    * @brief             - sets the retries for the next frame
+    *
+    * @param[in]         - reference to radio object (RF24)
+    * @param[in]         - kind of frame
+    * @param[in]         - frame length
+    *
+    * @return            - none
+    *
+    * @Note              - call while the tx fifo is empty, commands get
+    *                      the full count, control frames the adaptive
+    *                      one within the budget
+    *********************************************************************/
+    void apply(RF24& radio, Traffic traffic, uint8_t len) {
+        if (len != _budget_len || Control::period_ms() != _budget_period_ms) {
+            _budget_len = len;
+            _budget_period_ms = Control::period_ms();
+            _budget = budget_for(len);
+        }
+
+        uint8_t count = max_retries;
+        if (traffic == Traffic::CONTROL) count = min(_control_retries, _budget);
+
+        uint16_t setting = (_delay_code << 4) | count;
+        if (setting == _written) return;
+        radio.setRetries(_delay_code, count);
+        _written = setting;
+    }
+
+    /*********************************************************************
+    * @fn                - acked / failed
+    *
+    * @brief             - feed the outcome of every frame back
+    *
+    * @param[in]         - retries the frame needed (ARC)
+    * @param[in]         - kind of frame
+    *
+    * @return            - none
+    *
+    * @Note              - the count settles at twice the mean retries
+    *                      plus one, a loss raises it right away, calm
+    *                      acks lower it one step at a time. Most probed
+    *                      addresses have no vehicle, probes are ignored
+    *********************************************************************/
+    void acked(uint8_t retries, Traffic traffic) {
+        if (traffic == Traffic::PROBE) return;
+        if (traffic == Traffic::COMMAND) ++_commands_acked;
+        _arc_avg_x16 += ((retries << 4) - _arc_avg_x16) >> 3;
+
+        uint8_t target = (_arc_avg_x16 >> 3) + 1;
+        if (_control_retries <= target) {
+            _calm = 0;
+        } else if (++_calm >= calm_acks) {
+            --_control_retries;
+            _calm = 0;
+        }
+    }
+
+    void failed(Traffic traffic) {
+        if (traffic == Traffic::PROBE) return;
+        if (traffic == Traffic::COMMAND) ++_commands_lost;
+        else ++_controls_lost;
+
+        _calm = 0;
+        _control_retries = min(_control_retries + 2, _budget);
+    }
+
+    void print() {
+        Serial.print(F("retry: control="));  Serial.print(_control_retries);
+        Serial.print(F(" budget="));         Serial.print(_budget);
+        Serial.print(F(" delay="));          Serial.print(delay_us());
+        Serial.print(F("us mean x16="));     Serial.print(_arc_avg_x16);
+        Serial.print(F(" lost ctl="));       Serial.print(_controls_lost);
+        Serial.print(F(" cmd="));            Serial.print(_commands_lost);
+        Serial.print(F(" cmd acked="));      Serial.println(_commands_acked);
+    }
+
+    // helper functions
+    uint16_t air_us(uint8_t bytes) {
+        // preamble, 5 byte address, payload, 2 byte crc, 9 bit control field
+        uint16_t bits = 8 * (1 + 5 + bytes + 2) + 9;
+        switch (_rate) {
+        case RF24_2MBPS:    return bits / 2;
+        case RF24_250KBPS:  return bits * 4;
+        default:            return bits;
+        }
+    }
+
+    uint8_t budget_for(uint8_t len) {
+        uint16_t attempt_us = settle_us + air_us(len) + delay_us();
+        uint16_t attempts = static_cast<uint32_t>(_budget_period_ms) * 1000 / attempt_us;
+        return constrain(attempts, 2, max_retries + 1) - 1;
+    }
+}
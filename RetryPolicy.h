@@ -0,0 +1,38 @@
+/**
+ * @file RetryPolicy.h
+ *
+ * @brief Adaptive nRF24 auto-retry count and delay, control frames
+ *        only retry while they are still the newest input
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <RF24.h>
+
+namespace RetryPolicy {
+    // hardware limit of the auto retransmit count
+    const uint8_t max_retries = 15;
+
+    enum class Traffic : uint8_t {
+        CONTROL,    // superseded by the next frame, short retries
+        COMMAND,    // must get through, full retries
+        PROBE       // pairing, full retries, says nothing about the link
+    };
+
+    /********* state api *********/
+    uint8_t control_retries();
+    uint8_t retry_budget();
+    uint16_t delay_us();
+    uint16_t commands_acked();
+
+    // utility functions
+    void config_retries(RF24& radio);
+    void apply(RF24& radio, Traffic traffic, uint8_t len);
+    void acked(uint8_t retries, Traffic traffic);
+    void failed(Traffic traffic);
+
+    void print();
+}
@@ -9,8 +9,12 @@
  */
 #include "RotaryEncoder.h"
 #include "Arduino.h"
+#include "Power.h"
+#include "Events.h"
+#include "Trace.h"
+#include "Board.h"
 
-volatile int virtual_pos = 0;
+int virtual_pos = 0;
 int last_pos = 0;
 int re_sw_state = 1;
 
@@ -31,13 +35,12 @@ void rot_encoder_isr() {
     
       // If interrupts come faster than 5ms, assume it's a bounce and ignore
       if (interruptTime - lastInterruptTime > 5) {
-        if (digitalRead(re_dt_pin) == LOW)
-        {
-            virtual_pos-- ; // Could be -5 or -10
-        }
-        else {
-            virtual_pos++ ; // Could be +5 or +10
-        }
+        int8_t steps = Board::ReDt::read() ? 1 : -1;
+        Trace::record(Trace::Event::ENCODER_ISR, 128 + steps);
+        Events::post_turn(steps);
+
+        // leave low power mode right away
+        Power::wake();
     
         // Restrict value from 0 to +100
         //virtualPosition = min(100, max(0, virtualPosition));
@@ -46,6 +49,37 @@ void rot_encoder_isr() {
       lastInterruptTime = interruptTime;
 }
 
+/*********************************************************************
+* @fn                - rot_button_isr
+*
+* @brief             - debounces the knob button, called from the
+*                      pin change isr
+*
+* @param[in]         - none
+*
+* @return            - none
+*
+* @Note              - the pin change interrupt is shared with the
+*                      joystick buttons, so the pin itself is compared
+*                      with its last state
+*********************************************************************/
+void rot_button_isr() {
+    static unsigned long last_change_ms = 0;
+    static uint8_t last_state = HIGH;
+
+    uint8_t state = Board::ReSw::read() ? HIGH : LOW;
+    if (state == last_state) return;
+
+    // a bounce follows the previous edge closely
+    unsigned long now = millis();
+    if (state == LOW && now - last_change_ms > re_sw_debounce_ms) {
+        Trace::record(Trace::Event::BUTTON_ISR);
+        Events::post_press();
+    }
+    last_change_ms = now;
+    last_state = state;
+}
+
 /*********************************************************************
 * @fn                - config_rot_encoder
 *
@@ -59,14 +93,14 @@ void rot_encoder_isr() {
 *********************************************************************/
 void config_rot_encoder() {
     // config pins
-    pinMode(re_clk_pin, INPUT);
-    pinMode(re_dt_pin, INPUT);
-    pinMode(re_sw_pin, INPUT_PULLUP);
+    Board::ReClk::input();
+    Board::ReDt::input();
+    Board::ReSw::input_pullup();
 
     // Attach the routine to service the interrupts
-    attachInterrupt(digitalPinToInterrupt(re_clk_pin), rot_encoder_isr, LOW);
+    attachInterrupt(digitalPinToInterrupt(Board::ReClk::number), rot_encoder_isr, LOW);
 
-    Serial.println("    Rotary Encoder config complete!");
+    Serial.println(F("    Rotary Encoder config complete!"));
 }
 
 // testing only
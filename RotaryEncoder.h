@@ -11,19 +11,21 @@
 
 #include <stdint.h>
 
-// rotary encoder pins
-const uint8_t re_clk_pin    = 2;
-const uint8_t re_dt_pin     = 3;
-const uint8_t re_sw_pin     = 4;
+// rotary encoder pins: Board::ReClk, Board::ReDt and Board::ReSw
 
-// rotary encoder values
-extern volatile int virtual_pos;
+// press is ignored if the switch changed less than this ago
+const uint8_t re_sw_debounce_ms = 20;
+
+// rotary encoder values, owned by the main loop, the isrs only
+// post events
+extern int virtual_pos;
 extern int last_pos;
 extern int re_sw_state;
 
 // utility functions
 void config_rot_encoder();
 void rot_encoder_isr();
+void rot_button_isr();
 
 // testing only
 void process_rot_encoder_isr();
@@ -0,0 +1,74 @@
+/**
+ * @file Seqlock.h
+ *
+ * @brief Sequence lock, one writer publishes a value that readers
+ *        copy out consistently without disabling interrupts
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+template <typename T>
+class Seqlock {
+public:
+    Seqlock() : _seq(0) {}
+
+    /*********************************************************************
+    * @fn                - write
+    *
+    * @brief             - publishes a new value, writer side only
+    *
+    * @param[in]         - value to copy in
+    *
+    * @return            - none
+    *
+    * @Note              - the sequence is odd while the copy is going on
+    *********************************************************************/
+    void write(const T& val) {
+        _seq = _seq + 1;
+        barrier();
+        _val = val;
+        barrier();
+        _seq = _seq + 1;
+    }
+
+    /*********************************************************************
+    * @fn                - read
+    *
+    * @brief             - copies the newest complete value out
+    *
+    * @param[out]        - value copied out
+    *
+    * @return            - version of the value, changes with every write
+    *
+    * @Note              - the copy is retried when the writer ran in
+    *                      the middle of it, so a reader must never
+    *                      preempt the writer (e.g. writer isr, reader
+    *                      main loop), or it would spin forever
+    *********************************************************************/
+    uint8_t read(T& out) const {
+        uint8_t seq;
+        do {
+            seq = _seq;
+            barrier();
+            out = _val;
+            barrier();
+        } while ((seq & 1) || seq != _seq);
+        return seq;
+    }
+
+    uint8_t version() const {
+        return _seq;
+    }
+
+private:
+    static void barrier() {
+        __asm__ __volatile__("" ::: "memory");
+    }
+
+    volatile uint8_t _seq;
+    T _val;
+};
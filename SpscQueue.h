@@ -0,0 +1,80 @@
+/**
+ * @file SpscQueue.h
+ *
+ * @brief Lock-free single producer / single consumer ring buffer,
+ *        safe between one isr and the main loop
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+template <typename T, uint8_t Size>
+class SpscQueue {
+    static_assert(Size > 0 && Size <= 128 && (Size & (Size - 1)) == 0,
+                  "queue size must be a power of two up to 128");
+
+public:
+    SpscQueue() : _head(0), _tail(0) {}
+
+    /*********************************************************************
+    * @fn                - push
+    *
+    * @brief             - adds an item, producer side only
+    *
+    * @param[in]         - item to copy into the queue
+    *
+    * @return            - false if the queue is full
+    *
+    * @Note              - head and tail are single bytes, so reading
+    *                      or writing them is atomic on the avr
+    *********************************************************************/
+    bool push(const T& item) {
+        uint8_t head = _head;
+        if (static_cast<uint8_t>(head - _tail) == Size) return false;
+        _items[head & (Size - 1)] = item;
+
+        // the item must be in place before the consumer can see it
+        barrier();
+        _head = head + 1;
+        return true;
+    }
+
+    /*********************************************************************
+    * @fn                - pop
+    *
+    * @brief             - removes the oldest item, consumer side only
+    *
+    * @param[out]        - item copied out of the queue
+    *
+    * @return            - false if the queue is empty
+    *
+    * @Note              - none
+    *********************************************************************/
+    bool pop(T& item) {
+        uint8_t tail = _tail;
+        if (tail == _head) return false;
+        barrier();
+        item = _items[tail & (Size - 1)];
+
+        // the slot is only handed back once it was read
+        barrier();
+        _tail = tail + 1;
+        return true;
+    }
+
+    bool empty() const {
+        return _tail == _head;
+    }
+
+private:
+    static void barrier() {
+        __asm__ __volatile__("" ::: "memory");
+    }
+
+    T _items[Size];
+    volatile uint8_t _head;
+    volatile uint8_t _tail;
+};
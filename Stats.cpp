@@ -0,0 +1,67 @@
+/**
+ * @file Stats.cpp
+ *
+ * @brief Runtime statistics dump definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "Stats.h"
+#include "Latency.h"
+#include "Deadline.h"
+#include "I2cArbiter.h"
+#include "GlyphCache.h"
+#include "Memory.h"
+#include "Events.h"
+#include "RadioTx.h"
+#include "Trace.h"
+#include "Tuning.h"
+#include "Control.h"
+#include "RetryPolicy.h"
+#include "Fleet.h"
+#include "Boot.h"
+
+namespace Stats {
+    // tuning commands come in one line at a time
+    const uint8_t line_size = 16;
+    char _line[line_size];
+    uint8_t _line_len = 0;
+
+    // the dump outlasts the watchdog, the serial buffer is only 64
+    // bytes. Every section feeds it, with a neutral frame when late
+    void dump() {
+        Serial.println(F("---- stats ----"));
+        Boot::print();          Deadline::poll();
+        Deadline::print();      Deadline::poll();
+        Control::print();       Deadline::poll();
+        Latency::print();       Deadline::poll();
+        RadioTx::print();       Deadline::poll();
+        RetryPolicy::print();   Deadline::poll();
+        Fleet::print();         Deadline::poll();
+        I2cArbiter::print();    Deadline::poll();
+        GlyphCache::print();    Deadline::poll();
+        Memory::print();        Deadline::poll();
+        Tuning::print();        Deadline::poll();
+        Serial.print(F("ui: dropped events="));
+        Serial.println(Events::dropped());
+    }
+
+    void poll_serial() {
+        while (Serial.available()) {
+            char c = Serial.read();
+            if (c == '\n' || c == '\r') {
+                if (_line_len == 0) continue;
+                _line[_line_len] = '\0';
+                _line_len = 0;
+                Tuning::command(_line);
+            } else if (_line_len == 0 && c == 's') {
+                dump();
+            } else if (_line_len == 0 && c == 't') {
+                Trace::dump();
+            } else if (_line_len < line_size - 1) {
+                _line[_line_len++] = c;
+            }
+        }
+    }
+}
@@ -0,0 +1,18 @@
+/**
+ * @file Stats.h
+ *
+ * @brief Runtime statistics dump over serial
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+namespace Stats {
+    // dumps every statistic over serial
+    void dump();
+
+    // dumps the statistics when 's' is received over serial,
+    // the event trace on 't', any other line is a tuning command
+    void poll_serial();
+}
@@ -0,0 +1,215 @@
+/**
+ * @file Telemetry.cpp
+ *
+ * @brief Vehicle telemetry history definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "Telemetry.h"
+#include "Events.h"
+#include "Downlink.h"
+
+namespace Telemetry {
+    static_assert(CHANNEL_COUNT <= Downlink::channel_count, "telemetry channels must be downlink channels");
+
+    // channel names
+    const char name_temp[]     PROGMEM = "TEMP";
+    const char name_battery[]  PROGMEM = "BAT";
+    const char name_humidity[] PROGMEM = "HUM";
+    const char name_water[]    PROGMEM = "WATER";
+    const char name_light[]    PROGMEM = "LIGHT";
+    const char name_distance[] PROGMEM = "DIST";
+    const char name_accel[]    PROGMEM = "ACC";
+
+    const char* const names[] PROGMEM = {
+        name_temp,
+        name_battery,
+        name_humidity,
+        name_water,
+        name_light,
+        name_distance,
+        name_accel
+    };
+
+    // settings
+    uint16_t _sample_period_ms = 1000;
+    uint16_t _refresh_period_ms = 500;
+
+    // state
+    History _history[CHANNEL_COUNT];
+    int8_t _current[CHANNEL_COUNT];
+    uint8_t _vehicle = 0;
+    bool _changed = true;
+    unsigned long _last_sample_ms = 0;
+    unsigned long _last_refresh_ms = 0;
+
+    // helper functions prototypes
+    bool refresh_due();
+
+    /********* History *********/
+    void History::push(int8_t val) {
+        int8_t evicted = 0;
+        bool full = (_count == history_size);
+
+        if (full) {
+            evicted = _buf[_head];
+            _sum -= evicted;
+        } else {
+            ++_count;
+        }
+        _buf[_head] = val;
+        _head = (_head + 1 < history_size) ? _head + 1 : 0;
+        _sum += val;
+
+        // min/max only need a rescan when the evicted sample held them
+        if (full && (evicted == _min || evicted == _max)) {
+            rescan();
+        } else if (_count == 1) {
+            _min = _max = val;
+        } else {
+            if (val < _min) _min = val;
+            if (val > _max) _max = val;
+        }
+    }
+
+    void History::clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    uint8_t History::count() const {
+        return _count;
+    }
+
+    int8_t History::at(uint8_t idx) const {
+        uint8_t oldest = (_count == history_size) ? _head : 0;
+        uint8_t pos = oldest + idx;
+        return _buf[(pos < history_size) ? pos : pos - history_size];
+    }
+
+    int8_t History::last() const {
+        return _count ? at(_count - 1) : 0;
+    }
+
+    int8_t History::lowest() const {
+        return _min;
+    }
+
+    int8_t History::highest() const {
+        return _max;
+    }
+
+    int8_t History::mean() const {
+        return _count ? _sum / _count : 0;
+    }
+
+    void History::rescan() {
+        _min = _max = at(0);
+        for (uint8_t i = 1; i < _count; ++i) {
+            int8_t val = at(i);
+            if (val < _min) _min = val;
+            if (val > _max) _max = val;
+        }
+    }
+
+    /********* settings api *********/
+    uint16_t sample_period_ms() {
+        return _sample_period_ms;
+    }
+
+    uint16_t refresh_period_ms() {
+        return _refresh_period_ms;
+    }
+
+    void sample_period_ms(uint16_t val) {
+        _sample_period_ms = val;
+    }
+
+    void refresh_period_ms(uint16_t val) {
+        _refresh_period_ms = val;
+    }
+
+    /*********************************************************************
+    * @fn                - update
+    *
+    * @brief             - tracks value changes and appends a sample to
+    *                      every channel once per sample period
+    *
+    * @param[in]         - latest telemetry of the vehicle
+    * @param[in]         - vehicle index, history restarts when it changes
+    *
+    * @return            - none
+    *
+    * @Note              - none
+    *********************************************************************/
+    void update(const int8_t* data_in, uint8_t vehicle) {
+        if (vehicle != _vehicle) {
+            _vehicle = vehicle;
+            for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) _history[i].clear();
+            _changed = true;
+        }
+
+        if (memcmp(_current, data_in, sizeof(_current)) != 0) {
+            memcpy(_current, data_in, sizeof(_current));
+            _changed = true;
+        }
+
+        unsigned long now = millis();
+        if (now - _last_sample_ms >= _sample_period_ms) {
+            _last_sample_ms = now;
+            for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) _history[i].push(_current[i]);
+            _changed = true;
+        }
+
+        if (refresh_due()) Events::post_refresh();
+    }
+
+    const History& history(uint8_t channel) {
+        return _history[channel];
+    }
+
+    PGM_P name(uint8_t channel) {
+        return static_cast<PGM_P>(pgm_read_ptr(&names[channel]));
+    }
+
+    /*********************************************************************
+    * @fn                - sparkline_glyph
+    *
+    * @brief             - builds a 5x8 glyph with one bar per sample
+    *
+    * @param[in]         - channel
+    * @param[in]         - glyph index, 0 holds the oldest 5 samples
+    * @param[out]        - glyph bitmap
+    *
+    * @Note              - bars are scaled between the history min and
+    *                      max, the smallest bar is one pixel high
+    *********************************************************************/
+    void sparkline_glyph(uint8_t channel, uint8_t g, uint8_t glyph[8]) {
+        const History& h = _history[channel];
+        int16_t range = h.highest() - h.lowest();
+
+        memset(glyph, 0, 8);
+        for (uint8_t col = 0; col < 5; ++col) {
+            // right align the samples, so the newest is the last column
+            int16_t idx = g * 5 + col - (history_size - h.count());
+            if (idx < 0) continue;
+
+            uint8_t height = 1;
+            if (range > 0) height += (h.at(idx) - h.lowest()) * 7 / range;
+
+            for (uint8_t row = 8 - height; row < 8; ++row) {
+                glyph[row] |= 0x10 >> col;
+            }
+        }
+    }
+
+    // helper functions
+    bool refresh_due() {
+        unsigned long now = millis();
+        if (!_changed || now - _last_refresh_ms < _refresh_period_ms) return false;
+        _last_refresh_ms = now;
+        _changed = false;
+        return true;
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * @file Telemetry.h
+ *
+ * @brief Vehicle telemetry history with running min/max/mean
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+namespace Telemetry {
+    // channels, the first downlink channels (see Downlink.h)
+    enum Channel : uint8_t {
+        TEMP,
+        BATTERY,
+        HUMIDITY,
+        WATER,
+        LIGHT,
+        DISTANCE,
+        ACCELERATION,
+        CHANNEL_COUNT
+    };
+
+    // samples kept per channel, one sparkline glyph shows 5
+    const uint8_t history_size = 20;
+
+    // fixed-size ring buffer with incrementally updated statistics
+    class History {
+    public:
+        void push(int8_t val);
+        void clear();
+
+        uint8_t count() const;
+        int8_t at(uint8_t idx) const;   // 0 is the oldest sample
+        int8_t last() const;
+        int8_t lowest() const;
+        int8_t highest() const;
+        int8_t mean() const;
+    private:
+        void rescan();
+
+        int8_t _buf[history_size];
+        uint8_t _head;
+        uint8_t _count;
+        int8_t _min;
+        int8_t _max;
+        int16_t _sum;
+    };
+
+    /********* settings api *********/
+    uint16_t sample_period_ms();
+    uint16_t refresh_period_ms();
+    void sample_period_ms(uint16_t val);
+    void refresh_period_ms(uint16_t val);
+
+    // utility functions, update posts a refresh event at most once
+    // per refresh period, and only if a value shown on the lcd changed
+    void update(const int8_t* data_in, uint8_t vehicle);
+    const History& history(uint8_t channel);
+    PGM_P name(uint8_t channel);
+
+    // sparkline glyph (5 samples) g of 4 for the channel
+    void sparkline_glyph(uint8_t channel, uint8_t g, uint8_t glyph[8]);
+}
@@ -0,0 +1,112 @@
+/**
+ * @file Trace.cpp
+ *
+ * @brief Event trace ring buffer definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "Trace.h"
+#include "Latency.h"
+#include <util/atomic.h>
+#include <avr/wdt.h>
+
+namespace Trace {
+    struct Entry {
+        uint16_t stamp;     // Latency::stamp(), 4us per tick
+        uint8_t id;
+        uint8_t arg;
+    };
+
+    Entry _ring[capacity];
+    uint8_t _head = 0;
+    uint8_t _count = 0;
+
+    // entries left before freezing, 0 when no trigger is pending
+    uint8_t _post = 0;
+    bool _frozen = false;
+
+    /*********************************************************************
+    * @fn                - record
+    *
+    * @brief             - appends an event to the ring
+    *
+    * @param[in]         - event id
+    * @param[in]         - event argument
+    *
+    * @return            - none
+    *
+    * @Note              - the oldest entry is overwritten when full,
+    *                      nothing is recorded while frozen
+    *********************************************************************/
+    void record(Event id, uint8_t arg) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            if (_frozen) return;
+
+            Entry& e = _ring[_head];
+            e.stamp = Latency::stamp();
+            e.id = static_cast<uint8_t>(id);
+            e.arg = arg;
+
+            _head = (_head + 1) % capacity;
+            if (_count < capacity) ++_count;
+            if (_post != 0 && --_post == 0) _frozen = true;
+        }
+    }
+
+    void trigger(uint8_t post_entries) {
+        // the first trigger wins, later ones would hide its cause
+        if (_post != 0 || _frozen) return;
+        record(Event::TRIGGER);
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            _post = post_entries;
+            if (_post == 0) _frozen = true;
+        }
+    }
+
+    bool frozen() {
+        return _frozen;
+    }
+
+    /*********************************************************************
+    * @fn                - dump
+    *
+    * @brief             - prints every entry over serial
+    *
+    * @param[in]         - none
+    *
+    * @return            - none
+    *
+    * @Note              - one "stamp id arg" line per entry between
+    *                      "trace begin" and "trace end", the ring is
+    *                      frozen while printing
+    *********************************************************************/
+    void dump() {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            _frozen = true;
+        }
+
+        Serial.println(F("trace begin"));
+        uint8_t idx = (_head + capacity - _count) % capacity;
+        for (uint8_t n = 0; n < _count; ++n) {
+            const Entry& e = _ring[idx];
+            Serial.print(e.stamp);
+            Serial.print(' ');
+            Serial.print(e.id);
+            Serial.print(' ');
+            Serial.println(e.arg);
+            idx = (idx + 1) % capacity;
+
+            // ~900 characters in all, slow ports outlast the watchdog
+            wdt_reset();
+        }
+        Serial.println(F("trace end"));
+
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            _count = 0;
+            _post = 0;
+            _frozen = false;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/**
+ * @file Trace.h
+ *
+ * @brief Event trace ring buffer, recorded from isrs and the loop and
+ *        dumped over serial for tools/trace2chrome.py
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace Trace {
+    // keep in sync with EVENTS in tools/trace2chrome.py
+    enum class Event : uint8_t {
+        LOOP_BEGIN,
+        LOOP_END,
+        ENCODER_ISR,        // arg: steps + 128
+        BUTTON_ISR,
+        RADIO_IRQ,
+        I2C_BEGIN,          // arg: I2cArbiter::Client
+        I2C_END,            // arg: I2cArbiter::Client
+        TX_QUEUED,          // arg: vehicle index
+        TX_ACKED,
+        TX_FAILED,
+        TX_REPLACED,
+        DEADLINE_MISS,      // arg: iteration time / 256us
+        NEUTRAL_FRAME,
+        UI_EVENT,           // arg: Events::Type
+        TRIGGER
+    };
+
+    // entries in the ring, 4 bytes each
+    const uint8_t capacity = 64;
+
+    // safe from isrs, a few us per call
+    void record(Event id, uint8_t arg = 0);
+
+    // freezes the ring once post_entries more were recorded, so the
+    // dump shows what led to the trigger and a bit of what followed
+    void trigger(uint8_t post_entries = capacity / 4);
+    bool frozen();
+
+    // prints the ring oldest first and starts recording again
+    void dump();
+}
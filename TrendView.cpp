@@ -0,0 +1,52 @@
+/**
+ * @file TrendView.cpp
+ *
+ * @brief Telemetry trend page definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "TrendView.h"
+#include "Telemetry.h"
+#include "Display.h"
+#include "GlyphCache.h"
+#include "LcdCustomCharacters.h"
+
+namespace TrendView {
+    const char fmt_value[] PROGMEM = "%-5s %4d";
+    const char fmt_stats[] PROGMEM = "L%d H%d A%d";
+
+    /*********************************************************************
+    * @fn                - show
+    *
+    * @brief             - draws the trend page of a channel
+    *
+    * @param[in]         - telemetry channel
+    *
+    * @return            - none
+    *
+    * @Note              - row 1: name, last value and the sparkline of
+    *                      the whole history, row 2: min, max and mean
+    *********************************************************************/
+    void show(uint8_t channel) {
+        const Telemetry::History& h = Telemetry::history(channel);
+        char name[8];
+        char row[17];
+
+        Display::clear();
+        strncpy_P(name, Telemetry::name(channel), sizeof(name));
+        snprintf_P(row, sizeof(row), fmt_value, name, h.last());
+        Display::print(1, 0, row);
+        snprintf_P(row, sizeof(row), fmt_stats, h.lowest(), h.highest(), h.mean());
+        Display::print(1, 1, row);
+
+        // the glyph cache uploads the bars that changed
+        uint8_t glyph[8];
+        for (uint8_t g = 0; g < glyphs; ++g) {
+            Telemetry::sparkline_glyph(channel, g, glyph);
+            GlyphCache::define(SPARK_0 + g, glyph);
+            Display::glyph(16 - glyphs + g, 0, SPARK_0 + g);
+        }
+    }
+}
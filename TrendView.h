@@ -0,0 +1,20 @@
+/**
+ * @file TrendView.h
+ *
+ * @brief Telemetry trend page with a sparkline built from
+ *        runtime generated custom characters
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace TrendView {
+    // sparkline width, one dynamic glyph per character
+    const uint8_t glyphs = 4;
+
+    // draws the trend page of a channel into the display buffer
+    void show(uint8_t channel);
+}
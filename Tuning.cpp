@@ -0,0 +1,340 @@
+/**
+ * @file Tuning.cpp
+ *
+ * @brief Runtime radio and input parameters definitions
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include "Arduino.h"
+#include "Tuning.h"
+#include "Mpu6050.h"
+#include "Deadline.h"
+#include "RadioTx.h"
+#include "Configurations.h"
+#include "EepromLayout.h"
+#include <EEPROM.h>
+#include <avr/pgmspace.h>
+#include <util/crc16.h>
+#include <util/atomic.h>
+
+namespace Tuning {
+    // allowed values, menu step and default of each parameter
+    struct Limits {
+        int16_t lo;
+        int16_t hi;
+        int16_t step;
+        int16_t def;
+    };
+    const Limits limits[param_count] PROGMEM = {
+        { RF24_PA_MIN, RF24_PA_MAX,   1, RF24_PA_MIN },
+        {           0,         100,   1,           5 },
+        {           0,        2000,  20,         180 },
+        {        2000,       16000, 500,       12000 }
+    };
+
+    // names, and the letter that sets each parameter over serial
+    const char name_pa_level[]    PROGMEM = "PA LEVEL";
+    const char name_deadzone[]    PROGMEM = "DEADZONE";
+    const char name_tilt_buffer[] PROGMEM = "TILT BUF";
+    const char name_tilt_range[]  PROGMEM = "TILT RANGE";
+    const char* const names[param_count] PROGMEM = {
+        name_pa_level,
+        name_deadzone,
+        name_tilt_buffer,
+        name_tilt_range
+    };
+    const char letters[] = "pdbr";
+
+    // one eeprom slot, the newest valid one holds the profile, every
+    // save goes to the next slot so the writes are spread over all
+    struct Slot {
+        uint8_t seq;
+        int16_t values[param_count];
+        uint8_t crc;
+    };
+    const uint8_t slot_count = EepromLayout::tuning_size / sizeof(Slot);
+    static_assert(slot_count >= 2, "tuning area holds less than two slots");
+
+    // crc start value, so a slot of all zeros does not check out
+    const uint8_t crc_seed = 0x5A;
+
+    // settings
+    int16_t _values[param_count];
+
+    // profile, newest slot written and its sequence number
+    uint8_t _slot = slot_count - 1;
+    uint8_t _seq = 0xFF;
+    bool _stored = false;
+
+    // set when a value changed since the profile was loaded or saved
+    bool _unsaved = false;
+
+    // the pa level is only changed in between frames
+    bool _pa_dirty = false;
+
+    // helper functions prototypes
+    Limits param_limits(uint8_t idx);
+    void apply(Param p, int16_t old_val);
+    uint8_t slot_crc(const Slot& slot);
+    uint16_t slot_addr(uint8_t idx);
+
+    /********* settings api *********/
+    uint8_t pa_level() {
+        return _values[static_cast<uint8_t>(Param::PA_LEVEL)];
+    }
+
+    uint8_t deadzone() {
+        return _values[static_cast<uint8_t>(Param::DEADZONE)];
+    }
+
+    int16_t tilt_buffer() {
+        return _values[static_cast<uint8_t>(Param::TILT_BUFFER)];
+    }
+
+    int16_t tilt_range() {
+        return _values[static_cast<uint8_t>(Param::TILT_RANGE)];
+    }
+
+    int16_t value(Param p) {
+        return _values[static_cast<uint8_t>(p)];
+    }
+
+    /*********************************************************************
+    * @fn                - value
+    *
+    * @brief             - changes a parameter and applies it right away
+    *
+    * @param[in]         - parameter
+    * @param[in]         - new value, clamped to the parameter limits
+    *
+    * @return            - none
+    *
+    * @Note              - the loop and link counters start over, so the
+    *                      next stats dump shows the effect of the change
+    *                      alone, the profile is only stored by save()
+    *********************************************************************/
+    void value(Param p, int16_t val) {
+        uint8_t idx = static_cast<uint8_t>(p);
+        Limits lim = param_limits(idx);
+        val = constrain(val, lim.lo, lim.hi);
+        if (val == _values[idx]) return;
+
+        int16_t old_val = _values[idx];
+        _values[idx] = val;
+        _unsaved = true;
+        apply(p, old_val);
+
+        Deadline::reset();
+        RadioTx::reset();
+    }
+
+    void step(Param p, int8_t steps) {
+        Limits lim = param_limits(static_cast<uint8_t>(p));
+        value(p, value(p) + steps * lim.step);
+    }
+
+    void name(Param p, char* buf) {
+        strncpy_P(buf, (PGM_P)pgm_read_ptr(&names[static_cast<uint8_t>(p)]), 15);
+        buf[15] = '\0';
+    }
+
+    /*********************************************************************
+    * @fn                - load
+    *
+    * @brief             - restores the newest profile stored in eeprom
+    *
+    * @param[in]         - none
+    *
+    * @return            - none
+    *
+    * @Note              - the defaults are used when no slot is valid,
+    *                      sequence numbers wrap, a slot is newer when
+    *                      it is less than half the range ahead
+    *********************************************************************/
+    void load() {
+        _stored = false;
+        _unsaved = false;
+        for (uint8_t i = 0; i < slot_count; ++i) {
+            Slot slot;
+            EEPROM.get(slot_addr(i), slot);
+            if (slot.crc != slot_crc(slot)) continue;
+            if (_stored && static_cast<int8_t>(slot.seq - _seq) <= 0) continue;
+
+            _slot = i;
+            _seq = slot.seq;
+            _stored = true;
+            memcpy(_values, slot.values, sizeof(_values));
+        }
+
+        for (uint8_t i = 0; i < param_count; ++i) {
+            Limits lim = param_limits(i);
+            if (!_stored) _values[i] = lim.def;
+            _values[i] = constrain(_values[i], lim.lo, lim.hi);
+        }
+
+        // nothing is calibrated yet, the values are taken as they are
+        acc_buffer = tilt_buffer();
+        apply(Param::TILT_RANGE, tilt_range());
+        _pa_dirty = true;
+    }
+
+    /*********************************************************************
+    * @fn                - save
+    *
+    * @brief             - stores the current profile in eeprom
+    *
+    * @param[in]         - none
+    *
+    * @return            - false if the profile did not change
+    *
+    * @Note              - writes go round robin over the slots, so each
+    *                      one sees only a fraction of the saves
+    *********************************************************************/
+    bool save() {
+        _unsaved = false;
+        if (_stored) {
+            Slot last;
+            EEPROM.get(slot_addr(_slot), last);
+            if (memcmp(last.values, _values, sizeof(_values)) == 0) return false;
+        }
+
+        Slot slot;
+        slot.seq = _seq + 1;
+        memcpy(slot.values, _values, sizeof(slot.values));
+        slot.crc = slot_crc(slot);
+
+        uint8_t next = (_slot + 1) % slot_count;
+        EepromLayout::put(slot_addr(next), slot);
+        _slot = next;
+        _seq = slot.seq;
+        _stored = true;
+        return true;
+    }
+
+    bool saved() {
+        return !_unsaved;
+    }
+
+    /*********************************************************************
+    * @fn                - config_tuning
+    *
+    * @brief             - loads the stored profile and applies it
+    *
+    * @param[in]         - reference to radio object (RF24)
+    *
+    * @return            - none
+    *
+    * @Note              - call before config_mpu_6050, the calibration
+    *                      uses the tilt buffer
+    *********************************************************************/
+    void config_tuning(RF24& radio) {
+        load();
+        service(radio);
+        Serial.println(F("    Tuning config complete!"));
+    }
+
+    /*********************************************************************
+    * @fn                - service
+    *
+    * @brief             - applies a new pa level to the radio
+    *
+    * @param[in]         - reference to radio object (RF24)
+    *
+    * @return            - none
+    *
+    * @Note              - called from the main loop while no frame is
+    *                      in flight
+    *********************************************************************/
+    void service(RF24& radio) {
+        if (!_pa_dirty) return;
+        radio.setPALevel(pa_level());
+        _pa_dirty = false;
+    }
+
+    /*********************************************************************
+    * @fn                - command
+    *
+    * @brief             - runs a tuning command received over serial
+    *
+    * @param[in]         - command line, without the line ending
+    *
+    * @return            - none
+    *
+    * @Note              - p<n> pa level, d<n> deadzone, b<n> tilt
+    *                      buffer, r<n> tilt range, w stores the profile,
+    *                      ? prints the current values
+    *********************************************************************/
+    void command(const char* line) {
+        const char* letter = strchr(letters, line[0]);
+        if (line[0] != '\0' && letter != nullptr) {
+            value(static_cast<Param>(letter - letters), atoi(line + 1));
+        } else if (line[0] == 'w') {
+            Serial.println(save() ? F("tuning: saved") : F("tuning: unchanged"));
+        } else if (line[0] != '?') {
+            Serial.println(F("tuning: p<n> d<n> b<n> r<n> w ?"));
+            return;
+        }
+        print();
+    }
+
+    void print() {
+        Serial.print(F("tuning: pa="));     Serial.print(pa_level());
+        Serial.print(F(" deadzone="));      Serial.print(deadzone());
+        Serial.print(F(" buffer="));        Serial.print(tilt_buffer());
+        Serial.print(F(" range="));         Serial.print(tilt_range());
+        Serial.print(F(" slot="));          Serial.print(_slot);
+        Serial.print(F(" seq="));           Serial.print(_seq);
+        Serial.print(F(" stored="));        Serial.println(_stored);
+    }
+
+    // helper functions
+    Limits param_limits(uint8_t idx) {
+        Limits lim;
+        memcpy_P(&lim, &limits[idx], sizeof(lim));
+        return lim;
+    }
+
+    void apply(Param p, int16_t old_val) {
+        switch (p) {
+        case Param::PA_LEVEL:
+            _pa_dirty = true;
+            break;
+        case Param::TILT_BUFFER: {
+            // move the calibrated edges along with the buffer, the
+            // control isr reads them
+            int16_t delta = tilt_buffer() - old_val;
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                Mpu6050::min_x_acc(Mpu6050::min_x_acc() - delta);
+                Mpu6050::max_x_acc(Mpu6050::max_x_acc() + delta);
+                Mpu6050::min_y_acc(Mpu6050::min_y_acc() - delta);
+                Mpu6050::max_y_acc(Mpu6050::max_y_acc() + delta);
+            }
+            acc_buffer = tilt_buffer();
+            break;
+        }
+        case Param::TILT_RANGE:
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                Mpu6050::lower_boundary(-tilt_range());
+                Mpu6050::upper_boundary(tilt_range());
+            }
+            break;
+        default:
+            // the deadzone is read by the joystick pipelines every sample
+            break;
+        }
+    }
+
+    uint8_t slot_crc(const Slot& slot) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&slot);
+        uint8_t crc = crc_seed;
+        for (uint8_t i = 0; i < offsetof(Slot, crc); ++i) {
+            crc = _crc8_ccitt_update(crc, bytes[i]);
+        }
+        return crc;
+    }
+
+    uint16_t slot_addr(uint8_t idx) {
+        return EepromLayout::tuning_addr + idx * sizeof(Slot);
+    }
+}
@@ -0,0 +1,49 @@
+/**
+ * @file Tuning.h
+ *
+ * @brief Radio and input parameters that can be changed at runtime
+ *        from the tuning menu or over serial, persisted in eeprom
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <RF24.h>
+
+namespace Tuning {
+    enum class Param : uint8_t {
+        PA_LEVEL,       // RF24_PA_MIN..RF24_PA_MAX
+        DEADZONE,       // joystick resting band, adc counts each side
+        TILT_BUFFER,    // added around the calibrated tilt range
+        TILT_RANGE,     // mpu-6050 boundaries, +/- raw counts
+        PARAM_COUNT
+    };
+    const uint8_t param_count = static_cast<uint8_t>(Param::PARAM_COUNT);
+
+    /********* settings api *********/
+    uint8_t pa_level();
+    uint8_t deadzone();
+    int16_t tilt_buffer();
+    int16_t tilt_range();
+
+    int16_t value(Param p);
+    void value(Param p, int16_t val);
+    void step(Param p, int8_t steps);
+
+    // copies the parameter name into buf (16 bytes)
+    void name(Param p, char* buf);
+
+    /********* profile api *********/
+    void load();
+    bool save();
+    bool saved();
+
+    // utility functions
+    void config_tuning(RF24& radio);
+    void service(RF24& radio);
+    void command(const char* line);
+
+    void print();
+}
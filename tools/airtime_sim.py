@@ -0,0 +1,431 @@
+#!/usr/bin/env python3
+"""
+@file airtime_sim.py
+
+@brief Discrete-event simulator of several transmitters sharing the
+       nRF24 air (Enhanced ShockBurst with ack payloads)
+
+Every transmitter runs the frame policy of this sketch: a new control
+frame every period, a frame still waiting for its ack is replaced by the
+newer one (see RadioTx::send), and retries follow RetryPolicy, either a
+fixed count or the adaptive one. Each transmitter drives its own vehicle,
+which acks every frame with a full AckPackage.
+
+The model:
+  - air time    preamble, 5 byte address, payload, 2 byte crc and 9 bit
+                control field at the data rate, 130us pll settling before
+                the first attempt and before the ack
+  - retries     the retry delay (ARD) counts from the end of an attempt,
+                sized for the ack payload exactly like the firmware does
+  - collisions  any two packets on the same channel that overlap in time
+                are both lost (no capture effect)
+  - errors      every packet is also lost with probability --per
+  - ack loss    the vehicle got the frame but the ack was lost, the frame
+                is retried, the vehicle drops the duplicate and acks again
+  - clocks      random start phase and crystal drift per transmitter, so
+                equal periods slide past each other as they do on site
+
+Usage:
+    tools/airtime_sim.py --count 4
+    tools/airtime_sim.py --count 8 --sweep --runs 10
+    tools/airtime_sim.py --tx size=22,period=10,retries=adaptive,channel=76 \\
+                         --tx size=29,period=20,retries=15,channel=76
+
+A --tx spec takes any of size (bytes), period (ms), retries (0-15 or
+adaptive), channel and rate (250k, 1m, 2m). Keys left out come from the
+matching command line options.
+
+@author Gustavo Monardez
+"""
+import argparse
+import heapq
+import math
+import random
+import sys
+
+SETTLE_US = 130
+MARGIN_US = 50
+MAX_RETRIES = 15
+ACK_SIZE = 32       # sizeof(AckPackage)
+FRAME_SIZE = 19     # max_frame_len, the full input profile
+
+# bits per microsecond
+RATES = {"250k": 0.25, "1m": 1.0, "2m": 2.0}
+
+
+def air_us(nbytes, rate):
+    # same as RetryPolicy::air_us
+    bits = 8 * (1 + 5 + nbytes + 2) + 9
+    return bits / RATES[rate]
+
+
+def retry_delay_us(rate):
+    # same as RetryPolicy::config_retries
+    ack_us = SETTLE_US + air_us(ACK_SIZE, rate) + MARGIN_US
+    code = min(math.ceil(ack_us / 250) - 1, 15)
+    return (code + 1) * 250
+
+
+def retry_budget(size, period_us, rate):
+    # same as RetryPolicy::budget_for
+    attempt_us = SETTLE_US + air_us(size, rate) + retry_delay_us(rate)
+    attempts = int(period_us // attempt_us)
+    return min(max(attempts, 2), MAX_RETRIES + 1) - 1
+
+
+class FixedRetries:
+    def __init__(self, count):
+        self.count = count
+
+    def retries(self):
+        return self.count
+
+    def acked(self, arc):
+        pass
+
+    def failed(self):
+        pass
+
+
+class AdaptiveRetries:
+    """Mirror of RetryPolicy for control frames."""
+
+    INITIAL = 3
+    CALM_ACKS = 8
+
+    def __init__(self, budget):
+        self.budget = budget
+        self.count = self.INITIAL
+        self.avg_x16 = 0
+        self.calm = 0
+
+    def retries(self):
+        return min(self.count, self.budget)
+
+    def acked(self, arc):
+        self.avg_x16 += ((arc << 4) - self.avg_x16) >> 3
+        target = (self.avg_x16 >> 3) + 1
+        if self.count <= target:
+            self.calm = 0
+        else:
+            self.calm += 1
+            if self.calm >= self.CALM_ACKS:
+                self.count -= 1
+                self.calm = 0
+
+    def failed(self):
+        self.calm = 0
+        self.count = min(self.count + 2, self.budget)
+
+
+class Packet:
+    __slots__ = ("owner", "channel", "start", "end", "corrupted")
+
+    def __init__(self, owner, channel, start, end):
+        self.owner = owner
+        self.channel = channel
+        self.start = start
+        self.end = end
+        self.corrupted = False
+
+
+class Air:
+    """Packets on the air, per channel."""
+
+    def __init__(self, per, rng):
+        self.per = per
+        self.rng = rng
+        self.active = {}
+        self.busy_us = {}
+        self.collisions = 0
+
+    def start(self, pkt):
+        on_air = self.active.setdefault(pkt.channel, [])
+        for other in on_air:
+            if not other.corrupted or not pkt.corrupted:
+                self.collisions += 1
+            other.corrupted = True
+            pkt.corrupted = True
+        on_air.append(pkt)
+        self.busy_us[pkt.channel] = self.busy_us.get(pkt.channel, 0) + pkt.end - pkt.start
+
+    def end(self, pkt):
+        self.active[pkt.channel].remove(pkt)
+        if self.rng.random() < self.per:
+            pkt.corrupted = True
+        return not pkt.corrupted
+
+
+class Transmitter:
+    def __init__(self, idx, spec, sim):
+        self.idx = idx
+        self.sim = sim
+        self.size = spec["size"]
+        self.rate = spec["rate"]
+        self.channel = spec["channel"]
+        self.ard = retry_delay_us(self.rate)
+        self.air = air_us(self.size, self.rate)
+        self.ack_air = air_us(ACK_SIZE, self.rate)
+
+        drift = sim.rng.uniform(-sim.drift_ppm, sim.drift_ppm) * 1e-6
+        self.period = spec["period"] * 1000.0 * (1 + drift)
+        budget = retry_budget(self.size, spec["period"] * 1000.0, self.rate)
+        if spec["retries"] == "adaptive":
+            self.policy = AdaptiveRetries(budget)
+        else:
+            self.policy = FixedRetries(int(spec["retries"]))
+        self.label = "%d: %dB %gms r=%s ch%d %s" % (
+            idx, self.size, spec["period"], spec["retries"], self.channel, self.rate)
+
+        # frame in progress: id, creation time, attempt number, retries
+        # allowed, and whether the vehicle already has it
+        self.frame = None
+        self.created = 0.0
+        self.attempt = 0
+        self.allowed = 0
+        self.delivered = False
+        self.on_air_until = 0.0
+
+        # results
+        self.offered = 0
+        self.got = 0
+        self.lost = 0
+        self.replaced = 0
+        self.ack_lost = 0
+        self.attempts = 0
+        self.latency = []
+
+    def start(self):
+        self.sim.at(self.sim.rng.uniform(0, self.period), self.new_frame)
+
+    def new_frame(self):
+        now = self.sim.now
+        self.sim.at(now + self.period + self.sim.rng.uniform(-self.sim.jitter_us, self.sim.jitter_us),
+                    self.new_frame)
+        if now >= self.sim.duration:
+            return
+        if self.frame is not None:
+            # still waiting for an ack, the newer input wins
+            self.replaced += 1
+            if not self.delivered:
+                self.lost += 1
+        self.offered += 1
+        self.frame = self.offered
+        self.created = now
+        self.attempt = 0
+        self.allowed = self.policy.retries()
+        self.delivered = False
+        start = max(now, self.on_air_until) + SETTLE_US
+        self.sim.at(start, self.transmit, self.frame, 0)
+
+    def transmit(self, frame, attempt):
+        if frame != self.frame or attempt != self.attempt:
+            return
+        now = self.sim.now
+        pkt = Packet(self.idx, self.channel, now, now + self.air)
+        self.sim.air.start(pkt)
+        self.on_air_until = pkt.end
+        self.attempts += 1
+        self.sim.at(pkt.end, self.frame_end, pkt, frame, attempt)
+        self.sim.at(pkt.end + self.ard, self.ack_timeout, frame, attempt)
+
+    def frame_end(self, pkt, frame, attempt):
+        if not self.sim.air.end(pkt):
+            return
+        if frame == self.frame and not self.delivered:
+            self.delivered = True
+            self.got += 1
+            self.latency.append(pkt.end - self.created)
+
+        # the vehicle acks every copy it receives, duplicates included
+        start = pkt.end + SETTLE_US
+        ack = Packet(self.idx, self.channel, start, start + self.ack_air)
+        self.sim.at(start, self.ack_start, ack, frame, attempt)
+
+    def ack_start(self, ack, frame, attempt):
+        self.sim.air.start(ack)
+        self.sim.at(ack.end, self.ack_end, ack, frame, attempt)
+
+    def ack_end(self, ack, frame, attempt):
+        if not self.sim.air.end(ack):
+            return
+        if frame != self.frame or attempt != self.attempt:
+            return
+        self.policy.acked(attempt)
+        self.frame = None
+
+    def ack_timeout(self, frame, attempt):
+        if frame != self.frame or attempt != self.attempt:
+            return
+        if attempt < self.allowed:
+            self.attempt += 1
+            self.sim.at(self.sim.now, self.transmit, frame, self.attempt)
+            return
+
+        # max retries
+        self.policy.failed()
+        if self.delivered:
+            self.ack_lost += 1
+        else:
+            self.lost += 1
+        self.frame = None
+
+
+class Sim:
+    def __init__(self, specs, args, seed):
+        self.rng = random.Random(seed)
+        self.duration = args.duration * 1e6
+        self.drift_ppm = args.drift_ppm
+        self.jitter_us = args.jitter_us
+        self.air = Air(args.per, self.rng)
+        self.now = 0.0
+        self._events = []
+        self._seq = 0
+        self.txs = [Transmitter(i, spec, self) for i, spec in enumerate(specs)]
+
+    def at(self, when, fn, *args):
+        self._seq += 1
+        heapq.heappush(self._events, (when, self._seq, fn, args))
+
+    def run(self):
+        for tx in self.txs:
+            tx.start()
+        # let the frames created before the end finish their retries
+        end = self.duration + 100000
+        while self._events:
+            when, _, fn, args = heapq.heappop(self._events)
+            if when > end:
+                break
+            self.now = when
+            fn(*args)
+        return self
+
+
+def percentile(values, pct):
+    if not values:
+        return float("nan")
+    ordered = sorted(values)
+    idx = min(len(ordered) - 1, int(math.ceil(pct / 100.0 * len(ordered))) - 1)
+    return ordered[max(idx, 0)]
+
+
+def summary(txs):
+    offered = sum(t.offered for t in txs)
+    got = sum(t.got for t in txs)
+    lost = sum(t.lost for t in txs)
+    latency = [v for t in txs for v in t.latency]
+    return offered, got, lost, latency
+
+
+def report(sim):
+    secs = sim.duration / 1e6
+    print("%-34s %7s %7s %6s %6s %6s %6s %8s %8s %8s" % (
+        "transmitter", "frames", "deliv", "lost%", "repl", "ackls", "tx/fr",
+        "p50 us", "p95 us", "p99 us"))
+    for t in sim.txs:
+        print("%-34s %7d %6.1f%% %6.1f %6d %6d %6.2f %8.0f %8.0f %8.0f" % (
+            t.label, t.offered, 100.0 * t.got / max(t.offered, 1),
+            100.0 * t.lost / max(t.offered, 1), t.replaced, t.ack_lost,
+            t.attempts / max(t.offered, 1),
+            percentile(t.latency, 50), percentile(t.latency, 95), percentile(t.latency, 99)))
+
+    offered, got, lost, latency = summary(sim.txs)
+    print()
+    print("delivered %d of %d frames (%.1f%%), %.0f frames/s, %.0f payload bytes/s" % (
+        got, offered, 100.0 * got / max(offered, 1), got / secs,
+        sum(t.got * t.size for t in sim.txs) / secs))
+    print("lost %.1f%%, collisions %d, latency p50 %.0fus p95 %.0fus p99 %.0fus" % (
+        100.0 * lost / max(offered, 1), sim.air.collisions,
+        percentile(latency, 50), percentile(latency, 95), percentile(latency, 99)))
+    for ch in sorted(sim.air.busy_us):
+        print("channel %d: %.1f%% of the time on air" % (ch, 100.0 * sim.air.busy_us[ch] / sim.duration))
+
+
+def sweep(base, count, args):
+    # start phases decide a lot with few transmitters, so every count
+    # is run with --runs seeds and the results are pooled
+    print("%5s %8s %7s %10s %8s %8s %8s" % (
+        "count", "deliv", "lost", "collisions", "p50 us", "p95 us", "p99 us"))
+    for n in range(1, count + 1):
+        offered = got = lost = collisions = 0
+        latency = []
+        for run in range(args.runs):
+            sim = Sim(make_specs(base, n), args, args.seed + run).run()
+            o, g, l, lat = summary(sim.txs)
+            offered += o
+            got += g
+            lost += l
+            latency += lat
+            collisions += sim.air.collisions
+        print("%5d %7.1f%% %6.1f%% %10d %8.0f %8.0f %8.0f" % (
+            n, 100.0 * got / max(offered, 1), 100.0 * lost / max(offered, 1),
+            collisions // args.runs,
+            percentile(latency, 50), percentile(latency, 95), percentile(latency, 99)))
+
+
+def parse_spec(text, defaults):
+    spec = dict(defaults)
+    for item in filter(None, text.split(",")):
+        key, _, val = item.partition("=")
+        if key not in spec:
+            raise SystemExit("unknown key in --tx: %s" % key)
+        if key == "rate":
+            if val not in RATES:
+                raise SystemExit("rate must be one of %s" % ", ".join(RATES))
+            spec[key] = val
+        elif key == "retries":
+            spec[key] = val if val == "adaptive" else str(min(int(val), MAX_RETRIES))
+        elif key == "period":
+            spec[key] = float(val)
+        else:
+            spec[key] = int(val)
+    if spec["size"] > 32:
+        raise SystemExit("payloads are limited to 32 bytes")
+    return spec
+
+
+def make_specs(base, count):
+    # transmitters given with --tx are used in turn
+    return [dict(base[i % len(base)]) for i in range(count)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1].strip(),
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--tx", action="append", default=[], metavar="SPEC",
+                        help="one transmitter, key=value list (repeat for more)")
+    parser.add_argument("--count", type=int, default=0,
+                        help="number of transmitters (default: one per --tx, or 1)")
+    parser.add_argument("--size", type=int, default=FRAME_SIZE, help="frame size in bytes")
+    parser.add_argument("--period", type=float, default=10, help="frame period in ms")
+    parser.add_argument("--retries", default="adaptive", help="0-15 or adaptive")
+    parser.add_argument("--channel", type=int, default=76, help="rf channel")
+    parser.add_argument("--rate", default="1m", choices=sorted(RATES), help="data rate")
+    parser.add_argument("--per", type=float, default=0.0,
+                        help="packet error rate besides collisions (0-1)")
+    parser.add_argument("--drift-ppm", type=float, default=50, help="crystal tolerance")
+    parser.add_argument("--jitter-us", type=float, default=20, help="frame start jitter")
+    parser.add_argument("--duration", type=float, default=10, help="simulated seconds")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--sweep", action="store_true",
+                        help="run 1..count transmitters and print one line each")
+    parser.add_argument("--runs", type=int, default=5,
+                        help="seeds pooled per line of a sweep")
+    args = parser.parse_args()
+
+    defaults = {"size": args.size, "period": args.period, "retries": args.retries,
+                "channel": args.channel, "rate": args.rate}
+    if defaults["retries"] != "adaptive":
+        defaults["retries"] = str(min(int(defaults["retries"]), MAX_RETRIES))
+    base = [parse_spec(t, defaults) for t in args.tx] or [defaults]
+    count = args.count or len(base)
+
+    if args.sweep:
+        sweep(base, count, args)
+    else:
+        report(Sim(make_specs(base, count), args, args.seed).run())
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
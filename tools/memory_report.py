@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+@file memory_report.py
+
+@brief Static SRAM / flash budget report per module
+
+Reads the object files left in the Arduino build folder and prints, for
+every module, how many bytes it costs in flash and in SRAM.
+
+On AVR, .rodata is copied into SRAM at boot just like .data, so constant
+tables only stay out of SRAM when they are placed in a .progmem section.
+
+    flash = .text + .data + .rodata + .progmem*
+    sram  = .data + .rodata + .bss + .noinit
+
+Usage:
+    tools/memory_report.py <build_path> [--sram-budget BYTES] [--all]
+
+The build path is the one printed by the IDE with verbose compile output
+enabled, or the one given to `arduino-cli compile --build-path`. To run it
+on every build add a post link hook to platform.local.txt:
+
+    recipe.hooks.linking.postlink.1.pattern=python3 "{build.source.path}/tools/memory_report.py" "{build.path}"
+
+@author Gustavo Monardez
+"""
+import argparse
+import os
+import subprocess
+import sys
+
+# ATmega328P
+SRAM_SIZE = 2048
+FLASH_SIZE = 32256  # minus the bootloader
+
+
+def section_sizes(path, size_tool):
+    """returns {section: bytes} for an object or elf file"""
+    out = subprocess.run([size_tool, "-A", path], check=True,
+                         capture_output=True, text=True).stdout
+    sizes = {}
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0].startswith(".") and fields[1].isdigit():
+            sizes[fields[0]] = sizes.get(fields[0], 0) + int(fields[1])
+    return sizes
+
+
+def classify(sizes):
+    """splits section sizes into (flash, sram) bytes"""
+    flash = sram = 0
+    for name, size in sizes.items():
+        if name.startswith(".text") or name.startswith(".progmem"):
+            flash += size
+        elif name.startswith(".data") or name.startswith(".rodata"):
+            flash += size
+            sram += size
+        elif name.startswith(".bss") or name.startswith(".noinit"):
+            sram += size
+    return flash, sram
+
+
+def find_objects(build_path, include_all):
+    """sketch objects, plus core/library objects when requested"""
+    objects = []
+    for root, _, files in os.walk(build_path):
+        rel = os.path.relpath(root, build_path)
+        is_sketch = rel.split(os.sep)[0] == "sketch"
+        if not is_sketch and not include_all:
+            continue
+        for name in files:
+            if name.endswith(".o"):
+                objects.append(os.path.join(root, name))
+    return sorted(objects)
+
+
+def module_name(path, build_path):
+    rel = os.path.relpath(path, build_path)
+    for ext in (".ino.cpp.o", ".cpp.o", ".c.o", ".S.o", ".o"):
+        if rel.endswith(ext):
+            return rel[:-len(ext)]
+    return rel
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    parser.add_argument("build_path")
+    parser.add_argument("--sram-budget", type=int, default=0,
+                        help="fail when static sram exceeds this many bytes")
+    parser.add_argument("--all", action="store_true",
+                        help="include core and library objects")
+    parser.add_argument("--size-tool", default="avr-size")
+    args = parser.parse_args()
+
+    objects = find_objects(args.build_path, args.all)
+    if not objects:
+        sys.exit("no object files found under " + args.build_path)
+
+    rows = []
+    for obj in objects:
+        flash, sram = classify(section_sizes(obj, args.size_tool))
+        rows.append((module_name(obj, args.build_path), flash, sram))
+    rows.sort(key=lambda r: r[2], reverse=True)
+
+    print("%-40s %8s %8s" % ("module", "flash", "sram"))
+    for name, flash, sram in rows:
+        print("%-40s %8d %8d" % (name, flash, sram))
+
+    # linked image totals, after garbage collection of unused sections
+    elfs = [f for f in os.listdir(args.build_path) if f.endswith(".elf")]
+    static_sram = sum(r[2] for r in rows)
+    if elfs:
+        flash, static_sram = classify(section_sizes(
+            os.path.join(args.build_path, elfs[0]), args.size_tool))
+        print("-" * 58)
+        print("%-40s %8d %8d" % ("linked image", flash, static_sram))
+        print("flash used %d of %d bytes, static sram %d of %d bytes "
+              "(%d left for heap and stack)" % (
+                  flash, FLASH_SIZE, static_sram, SRAM_SIZE,
+                  SRAM_SIZE - static_sram))
+
+    if args.sram_budget and static_sram > args.sram_budget:
+        sys.exit("static sram %d exceeds budget of %d bytes"
+                 % (static_sram, args.sram_budget))
+
+
+if __name__ == "__main__":
+    main()
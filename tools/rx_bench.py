@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""
+@file rx_bench.py
+
+@brief Builds the vehicle receive engine on the host against a loopback
+       radio, checks it end to end and benchmarks frame decoding
+
+The receiver (ProcessDataIn.h/.cpp) is compiled from the sketch sources
+together with the transmitter's DataPackage, so a layout change on either
+side breaks this build the same way it breaks the firmware. The loopback
+check sends frames encoded the way send_data does through LoopbackRadio
+and verifies the decoded frames, the rejections (duplicate, stale, bad
+length, bad command, bad motion, bad profile), the ack payloads, the
+silence watchdog and irq mode, and that frames of every input profile
+decode. Then it reports decoded frames per second, for decode alone
+and for the full write -> fifo -> service -> ack path.
+
+Usage:
+    tools/rx_bench.py [--frames N] [--min-fps FPS] [--cxx c++]
+
+Run it with every change to DataPackage.h or ProcessDataIn.*, next to
+the firmware build.
+
+@author Gustavo Monardez
+"""
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+TOOLS = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(TOOLS)
+BENCH = os.path.join(TOOLS, "rx_bench")
+
+SOURCES = [
+    os.path.join(BENCH, "rx_bench.cpp"),
+    os.path.join(REPO, "ProcessDataIn.cpp"),
+    os.path.join(REPO, "Downlink.cpp"),
+]
+
+
+def build(cxx, out):
+    cmd = [cxx, "-std=c++11", "-O2", "-Wall", "-Wextra", "-Werror",
+           "-I", REPO, "-I", BENCH, "-I", os.path.join(BENCH, "host"),
+           "-o", out] + SOURCES
+    subprocess.run(cmd, check=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    parser.add_argument("--frames", type=int, default=2000000,
+                        help="frames decoded by the benchmark")
+    parser.add_argument("--min-fps", type=float, default=0,
+                        help="fail when the loopback path decodes fewer frames per second")
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"))
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        exe = os.path.join(tmp, "rx_bench")
+        try:
+            build(args.cxx, exe)
+        except subprocess.CalledProcessError:
+            sys.exit("rx_bench build failed")
+
+        run = subprocess.run([exe, str(args.frames)], capture_output=True, text=True)
+        sys.stdout.write(run.stdout)
+        if run.returncode != 0:
+            sys.exit("rx_bench failed")
+
+    match = re.search(r"loopback fps\s+(\d+)", run.stdout)
+    if args.min_fps and (match is None or float(match.group(1)) < args.min_fps):
+        sys.exit("loopback path below %.0f frames/s" % args.min_fps)
+
+
+if __name__ == "__main__":
+    main()
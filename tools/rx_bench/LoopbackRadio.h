@@ -0,0 +1,95 @@
+/**
+ * @file LoopbackRadio.h
+ *
+ * @brief Host stand-in for a pair of nRF24 radios, what the
+ *        transmitter side writes lands in the receiver rx fifo and
+ *        comes back with the staged ack payload
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+class LoopbackRadio {
+public:
+    // the chip keeps three payloads in each direction
+    static const uint8_t fifo_depth = 3;
+
+    LoopbackRadio() : _rx_count(0), _ack_count(0), _ack_len(0) {}
+
+    /********* transmitter side *********/
+
+    // false when the rx fifo is full, the frame is not acked then
+    bool write(const void* buf, uint8_t len) {
+        if (_rx_count == fifo_depth || len > 32) return false;
+        Payload& p = _rx[_rx_count++];
+        memcpy(p.data, buf, len);
+        p.len = len;
+
+        // the ack leaves with whatever is at the head of the ack fifo
+        _ack_len = 0;
+        if (_ack_count > 0) {
+            _ack_len = _ack[0].len;
+            memcpy(_ack_data, _ack[0].data, _ack_len);
+            pop(_ack, _ack_count);
+        }
+        return true;
+    }
+
+    // ack payload of the last frame written, 0 bytes if none was staged
+    uint8_t ack(void* buf) const {
+        memcpy(buf, _ack_data, _ack_len);
+        return _ack_len;
+    }
+
+    /********* receiver side, the RF24 subset Receiver needs *********/
+    bool available() {
+        return _rx_count > 0;
+    }
+
+    uint8_t getDynamicPayloadSize() {
+        return _rx_count ? _rx[0].len : 0;
+    }
+
+    void read(void* buf, uint8_t len) {
+        if (_rx_count == 0) return;
+        memcpy(buf, _rx[0].data, len);
+        pop(_rx, _rx_count);
+    }
+
+    bool writeAckPayload(uint8_t pipe, const void* buf, uint8_t len) {
+        (void)pipe;
+        if (_ack_count == fifo_depth || len > 32) return false;
+        Payload& p = _ack[_ack_count++];
+        memcpy(p.data, buf, len);
+        p.len = len;
+        return true;
+    }
+
+    void whatHappened(bool& tx_ok, bool& tx_fail, bool& rx_ready) {
+        tx_ok = false;
+        tx_fail = false;
+        rx_ready = _rx_count > 0;
+    }
+
+private:
+    struct Payload {
+        uint8_t data[32];
+        uint8_t len;
+    };
+
+    static void pop(Payload* fifo, uint8_t& count) {
+        memmove(fifo, fifo + 1, sizeof(Payload) * (count - 1));
+        --count;
+    }
+
+    Payload _rx[fifo_depth];
+    Payload _ack[fifo_depth];
+    uint8_t _rx_count;
+    uint8_t _ack_count;
+    uint8_t _ack_data[32];
+    uint8_t _ack_len;
+};
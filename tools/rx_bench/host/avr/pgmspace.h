@@ -0,0 +1,13 @@
+/**
+ * @file pgmspace.h
+ *
+ * @brief Host stand-in for avr/pgmspace.h, flash data is plain data
+ *        on the host
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#pragma once
+
+#define PROGMEM
+#define PGM_P const char*
@@ -0,0 +1,395 @@
+/**
+ * @file rx_bench.cpp
+ *
+ * @brief Host loopback check and decode benchmark of the vehicle
+ *        receive engine, built by tools/rx_bench.py
+ *
+ * @author Gustavo Monardez
+ *
+ */
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include "LoopbackRadio.h"
+#include "ProcessDataIn.h"
+#include "CommandCodes.h"
+#include "Downlink.h"
+
+using ProcessDataIn::Decode;
+using ProcessDataIn::Frame;
+using ProcessDataIn::Receiver;
+
+// transmitter frame period, as Control::period_ms
+const uint32_t period_us = 10000;
+const uint16_t period_ticks = period_us >> 2;
+
+int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        ++failures; \
+    } \
+} while (0)
+
+// helper functions prototypes
+DataPackage make_pkg(uint16_t seed);
+uint8_t encode(const DataPackage& pkg, uint8_t samples, uint8_t* out);
+template <uint8_t Profile> void profile_check();
+void loopback_check();
+void irq_check();
+void downlink_check();
+void benchmark(uint32_t frames);
+
+int main(int argc, char** argv) {
+    uint32_t frames = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 2000000;
+
+    loopback_check();
+    profile_check<InputProfile::FULL>();
+    profile_check<InputProfile::STICKS>();
+    profile_check<InputProfile::ONE_STICK>();
+    profile_check<InputProfile::TILT>();
+    irq_check();
+    downlink_check();
+    if (failures) {
+        printf("%d loopback check(s) failed\n", failures);
+        return 1;
+    }
+    printf("loopback check ok\n");
+
+    benchmark(frames);
+    return 0;
+}
+
+// helper functions
+DataPackage make_pkg(uint16_t seed) {
+    DataPackage pkg;
+    memset(&pkg, 0, sizeof(pkg));
+    pkg.j1.left = seed;
+    pkg.j1.up = seed >> 1;
+    pkg.j2.right = seed * 3;
+    pkg.j2.down = seed * 5;
+
+    // the Instance setters live in Mpu6050.cpp, which needs the wire
+    // library, the bytes are set directly instead
+    uint8_t* mpu = reinterpret_cast<uint8_t*>(&pkg.mpu);
+    mpu[0] = seed * 7;
+    mpu[4] = 25;
+    pkg.menu_select = seed % command_count;
+    pkg.tx_stamp = seed * period_ticks;
+    return pkg;
+}
+
+// same as send_data with the full profile, the frame and a motion
+// block cut to the samples it carries, the ack fields are set by the
+// caller
+uint8_t encode(const DataPackage& pkg, uint8_t samples, uint8_t* out) {
+    uint8_t len = pack_frame<InputProfile::FULL>(pkg, out);
+    if (samples == 0) return len;
+
+    MotionBlock motion;
+    motion.count = samples;
+    for (uint8_t i = 0; i < samples; ++i) {
+        motion.samples[i].x_acc = i * 10 - 20;
+        motion.samples[i].y_acc = 20 - i * 10;
+        motion.samples[i].age = (samples - i) * 8;
+    }
+    memcpy(out + len, &motion, motion_block_len(samples));
+    return len + motion_block_len(samples);
+}
+
+// a transmitter built with Profile, the vehicle takes its inputs and
+// leaves the others at rest
+template <uint8_t Profile>
+void profile_check() {
+    LoopbackRadio radio;
+    Receiver<LoopbackRadio> rx(radio);
+    uint8_t buf[32];
+    const uint8_t inputs = InputProfile::inputs(Profile);
+    rx.begin(1, false, 0);
+
+    DataPackage pkg = make_pkg(7);
+    uint8_t len = pack_frame<Profile>(pkg, buf);
+    CHECK(len == frame_len(Profile));
+    CHECK(radio.write(buf, len));
+    CHECK(rx.service(100));
+
+    const DataPackage& got = rx.frame().pkg;
+    DataPackage zero;
+    memset(&zero, 0, sizeof(zero));
+    CHECK(got.profile == Profile);
+    CHECK(got.tx_stamp == pkg.tx_stamp && got.menu_select == pkg.menu_select);
+    CHECK(memcmp(&got.j1, (inputs & InputProfile::J1) ? &pkg.j1 : &zero.j1, sizeof(Joystick)) == 0);
+    CHECK(memcmp(&got.j2, (inputs & InputProfile::J2) ? &pkg.j2 : &zero.j2, sizeof(Joystick)) == 0);
+    CHECK(memcmp(&got.mpu, (inputs & InputProfile::IMU) ? &pkg.mpu : &zero.mpu, mpu_len) == 0);
+
+    // a motion block only goes with tilt
+    pkg.tx_stamp += period_ticks;
+    len = pack_frame<Profile>(pkg, buf);
+    buf[len] = 0;
+    radio.write(buf, len + motion_block_len(0));
+    bool imu = inputs & InputProfile::IMU;
+    CHECK(rx.service(200) == imu);
+    CHECK(rx.rejected(Decode::BAD_LENGTH) == (imu ? 0 : 1));
+
+    printf("profile %u       %u byte frame\n", Profile, len);
+}
+
+void loopback_check() {
+    LoopbackRadio radio;
+    Receiver<LoopbackRadio> rx(radio);
+    uint32_t now = 0;
+    uint8_t buf[32];
+    AckPackage ack;
+
+    Downlink::Decoder downlink;
+
+    int8_t telemetry[7] = { 21, 80, 40, 0, 60, 120, 3 };
+    rx.telemetry(telemetry, sizeof(telemetry));
+    rx.begin(1, false, now);
+    CHECK(!rx.link());
+
+    // plain and motion frames come out as they went in, every ack
+    // echoes the stamp of the frame before
+    uint16_t previous = 0;
+    for (uint16_t i = 1; i <= 40; ++i) {
+        now += period_us;
+        DataPackage pkg = make_pkg(i);
+        pkg.ack_seq = downlink.ack_seq();
+        pkg.ack_bits = downlink.ack_bits();
+        uint8_t samples = i % (max_motion_samples + 1);
+        uint8_t len = encode(pkg, samples, buf);
+        CHECK(radio.write(buf, len));
+        CHECK(rx.service(now));
+
+        const Frame& f = rx.frame();
+        CHECK(memcmp(&f.pkg, &pkg, sizeof(pkg)) == 0);
+        CHECK(f.motion.count == samples);
+        if (samples) CHECK(memcmp(&f.motion, buf + max_frame_len, motion_block_len(samples)) == 0);
+
+        uint8_t ack_len = radio.ack(&ack);
+        CHECK(ack_len >= ack_header_size + Downlink::header_size);
+        CHECK(downlink.decode(reinterpret_cast<uint8_t*>(ack.telemetry), ack_len - ack_header_size));
+        if (i > 1) CHECK(ack.echo_stamp == previous);
+        // the mean interval settles on the frame period
+        if (i > 2) CHECK(ack.hold == period_ticks);
+        previous = pkg.tx_stamp;
+    }
+    CHECK(rx.link());
+    CHECK(rx.frames() == 40);
+    CHECK(memcmp(downlink.values(), telemetry, sizeof(telemetry)) == 0);
+    DataPackage accepted = rx.frame().pkg;
+
+    // the same frame again (lost ack), then an older one
+    DataPackage last = make_pkg(40);
+    radio.write(buf, encode(last, 0, buf));
+    CHECK(!rx.service(now += 100));
+    CHECK(rx.rejected(Decode::DUPLICATE) == 1);
+
+    radio.write(buf, encode(make_pkg(39), 0, buf));
+    CHECK(!rx.service(now += 100));
+    CHECK(rx.rejected(Decode::STALE) == 1);
+
+    // malformed frames
+    radio.write(buf, 10);
+    CHECK(!rx.service(now += 100));
+    CHECK(rx.rejected(Decode::BAD_LENGTH) == 1);
+
+    uint8_t len = encode(make_pkg(41), 2, buf);
+    radio.write(buf, len - 1);
+    CHECK(!rx.service(now += 100));
+    CHECK(rx.rejected(Decode::BAD_LENGTH) == 2);
+
+    DataPackage bad = make_pkg(41);
+    bad.menu_select = command_count;
+    radio.write(buf, encode(bad, 0, buf));
+    CHECK(!rx.service(now += 100));
+    CHECK(rx.rejected(Decode::BAD_COMMAND) == 1);
+
+    len = encode(make_pkg(41), 3, buf);
+    MotionSample* samples = reinterpret_cast<MotionSample*>(buf + max_frame_len + 1);
+    samples[2].age = samples[0].age + 1;
+    radio.write(buf, len);
+    CHECK(!rx.service(now += 100));
+    CHECK(rx.rejected(Decode::BAD_MOTION) == 1);
+
+    encode(make_pkg(41), 0, buf);
+    buf[0] = InputProfile::PROFILE_COUNT;
+    radio.write(buf, max_frame_len);
+    CHECK(!rx.service(now += 100));
+    CHECK(rx.rejected(Decode::BAD_PROFILE) == 1);
+
+    // rejected frames never touched the outputs
+    CHECK(memcmp(&rx.frame().pkg, &accepted, sizeof(accepted)) == 0);
+    CHECK(rx.frames() == 40);
+
+    // silence, the outputs go neutral
+    now += rx.silence_us() + 1;
+    CHECK(!rx.service(now));
+    CHECK(!rx.link());
+    CHECK(rx.timeouts() == 1);
+    Frame zero;
+    memset(&zero, 0, sizeof(zero));
+    CHECK(memcmp(&rx.frame(), &zero, sizeof(zero)) == 0);
+
+    // a transmitter back after a long gap (e.g. an idle heartbeat) has
+    // a stamp that looks older, it is taken since the link was down
+    DataPackage back = make_pkg(3);
+    radio.write(buf, encode(back, 0, buf));
+    CHECK(rx.service(now += 100));
+    CHECK(rx.link());
+    CHECK(memcmp(&rx.frame().pkg, &back, sizeof(back)) == 0);
+
+    // the receiver staged one ack per payload, none are left over
+    uint8_t staged = 0;
+    while (radio.writeAckPayload(1, &ack, sizeof(ack))) ++staged;
+    CHECK(staged == LoopbackRadio::fifo_depth - 1);
+}
+
+void irq_check() {
+    LoopbackRadio radio;
+    Receiver<LoopbackRadio> rx(radio);
+    uint32_t now = 0;
+    uint8_t buf[32];
+
+    rx.begin(1, true, now);
+
+    // no irq, the fifo is left alone
+    radio.write(buf, encode(make_pkg(1), 0, buf));
+    CHECK(!rx.service(now += 1000));
+
+    // the irq drains it
+    rx.irq();
+    CHECK(rx.service(now += 100));
+    CHECK(rx.irq_misses() == 0);
+
+    // a missed irq is caught after a quarter of the silence time
+    radio.write(buf, encode(make_pkg(2), 0, buf));
+    CHECK(rx.service(now += (rx.silence_us() >> 2) + 1));
+    CHECK(rx.irq_misses() == 1);
+    CHECK(rx.link());
+}
+
+void downlink_check() {
+    LoopbackRadio radio;
+    Receiver<LoopbackRadio> rx(radio);
+    Downlink::Decoder downlink;
+    uint32_t now = 0;
+    uint8_t buf[32];
+    AckPackage ack;
+    srand(1);
+
+    // two fast channels, every other one at the default slow period
+    Downlink::Scheduler& scheduler = rx.downlink();
+    scheduler.period(5, 1);
+    scheduler.period(6, 1);
+    int8_t values[Downlink::channel_count];
+    for (uint8_t ch = 0; ch < Downlink::channel_count; ++ch) values[ch] = ch * 7;
+    rx.telemetry(values, sizeof(values));
+    rx.begin(1, false, now);
+
+    // readings drift, now and then jump, one ack payload in five is lost
+    uint32_t bytes = 0;
+    uint16_t frames = 3000;
+    for (uint16_t i = 1; i <= frames + 40; ++i) {
+        // the ack leaving now was staged with the readings of the
+        // frame before
+        int8_t staged_fast = scheduler.value(5);
+        if (i <= frames) {
+            for (uint8_t ch = 0; ch < Downlink::channel_count; ++ch) {
+                int r = rand() % 100;
+                if (r < 10) values[ch] += (rand() % 5) - 2;
+                else if (r < 11) values[ch] = rand();
+            }
+            rx.telemetry(values, sizeof(values));
+        }
+
+        DataPackage pkg = make_pkg(i);
+        pkg.ack_seq = downlink.ack_seq();
+        pkg.ack_bits = downlink.ack_bits();
+        radio.write(buf, encode(pkg, 0, buf));
+        CHECK(rx.service(now += period_us));
+
+        uint8_t len = radio.ack(&ack) - ack_header_size;
+        bytes += len;
+        if (rand() % 5 == 0) continue;
+        uint16_t incomplete = downlink.incomplete();
+        CHECK(downlink.decode(reinterpret_cast<uint8_t*>(ack.telemetry), len));
+
+        // fast channels are as new as the payload, unless it was a
+        // delta against a base that is gone
+        if (i > 1 && downlink.incomplete() == incomplete) CHECK(downlink.values()[5] == staged_fast);
+    }
+
+    // once the readings settle every channel catches up
+    CHECK(memcmp(downlink.values(), values, sizeof(values)) == 0);
+    CHECK(downlink.invalid() == 0);
+
+    printf("downlink        %u channels, %.1f bytes/payload, %u keys, %u resent, %u incomplete\n",
+           Downlink::channel_count, static_cast<double>(bytes) / (frames + 40),
+           scheduler.keys(), scheduler.resent(), downlink.incomplete());
+}
+
+void benchmark(uint32_t frames) {
+    typedef std::chrono::steady_clock Clock;
+
+    // a mix of what the transmitter sends
+    const uint8_t variants = 64;
+    uint8_t payloads[variants][32];
+    uint8_t lens[variants];
+    for (uint8_t i = 0; i < variants; ++i) {
+        lens[i] = encode(make_pkg(i + 1), i % (max_motion_samples + 1), payloads[i]);
+    }
+
+    // decode alone
+    Frame frame;
+    uint32_t ok = 0;
+    Clock::time_point start = Clock::now();
+    for (uint32_t i = 0; i < frames; ++i) {
+        uint8_t v = i & (variants - 1);
+        ok += ProcessDataIn::decode(payloads[v], lens[v], frame) == Decode::OK;
+    }
+    double decode_s = std::chrono::duration<double>(Clock::now() - start).count();
+    CHECK(ok == frames);
+
+    // full path, transmitter write, fifo, receiver service, telemetry
+    // scheduled into the ack and decoded back
+    LoopbackRadio radio;
+    Receiver<LoopbackRadio> rx(radio);
+    Downlink::Decoder downlink;
+    uint32_t now = 0;
+    AckPackage ack;
+    int8_t values[Downlink::channel_count];
+    memset(values, 0, sizeof(values));
+    rx.downlink().period(5, 1);
+    rx.downlink().period(6, 1);
+    rx.begin(1, false, now);
+
+    start = Clock::now();
+    for (uint32_t i = 0; i < frames; ++i) {
+        values[i & (Downlink::channel_count - 1)] += 1;
+        rx.telemetry(values, sizeof(values));
+
+        uint8_t v = i & (variants - 1);
+        DataPackage* pkg = reinterpret_cast<DataPackage*>(payloads[v]);
+        pkg->tx_stamp += variants * period_ticks;
+        pkg->ack_seq = downlink.ack_seq();
+        pkg->ack_bits = downlink.ack_bits();
+        radio.write(payloads[v], lens[v]);
+        now += period_us;
+        rx.service(now);
+
+        uint8_t len = radio.ack(&ack) - ack_header_size;
+        downlink.decode(reinterpret_cast<uint8_t*>(ack.telemetry), len);
+    }
+    double loop_s = std::chrono::duration<double>(Clock::now() - start).count();
+    CHECK(rx.frames() == static_cast<uint16_t>(frames));
+
+    printf("frames          %u\n", frames);
+    printf("decode fps      %.0f (%.1f ns/frame)\n", frames / decode_s, decode_s * 1e9 / frames);
+    printf("loopback fps    %.0f (%.1f ns/frame)\n", frames / loop_s, loop_s * 1e9 / frames);
+    if (failures) {
+        printf("%d benchmark check(s) failed\n", failures);
+        exit(1);
+    }
+}
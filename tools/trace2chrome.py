@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+@file trace2chrome.py
+
+@brief Converts a serial trace dump into Chrome trace / Perfetto JSON
+
+Send 't' over serial to get a dump of the trace ring (see Trace.h). The
+dump is one "stamp id arg" line per event between "trace begin" and
+"trace end". Stamps are Latency::stamp() values: 4us per tick, 16 bits
+wide, so they wrap every ~262ms. They are unwrapped here assuming
+consecutive events are closer than that, which the 20ms control loop
+guarantees.
+
+Usage:
+    tools/trace2chrome.py serial.log [-o trace.json] [--dump N]
+
+Open the output in chrome://tracing or https://ui.perfetto.dev.
+
+@author Gustavo Monardez
+"""
+import argparse
+import json
+import sys
+
+US_PER_TICK = 4
+STAMP_WRAP = 1 << 16
+
+# keep in sync with Trace::Event in Trace.h
+# id: (name, phase, track), phase B/E opens/closes a slice, i is instant
+EVENTS = {
+    0: ("loop", "B", "loop"),
+    1: ("loop", "E", "loop"),
+    2: ("encoder", "i", "isr"),
+    3: ("button", "i", "isr"),
+    4: ("radio irq", "i", "isr"),
+    5: ("i2c", "B", "i2c"),
+    6: ("i2c", "E", "i2c"),
+    7: ("tx queued", "i", "radio"),
+    8: ("tx acked", "i", "radio"),
+    9: ("tx failed", "i", "radio"),
+    10: ("tx replaced", "i", "radio"),
+    11: ("deadline miss", "i", "loop"),
+    12: ("neutral frame", "i", "radio"),
+    13: ("ui event", "i", "loop"),
+    14: ("trigger", "i", "loop"),
+}
+
+TRACKS = ["loop", "isr", "i2c", "radio"]
+I2C_CLIENTS = {0: "i2c imu", 1: "i2c lcd"}
+UI_EVENTS = {0: "turn", 1: "press", 2: "refresh"}
+
+
+def read_dumps(lines):
+    """returns every dump as a list of (stamp, id, arg) tuples"""
+    dumps = []
+    current = None
+    for line in lines:
+        line = line.strip()
+        if line == "trace begin":
+            current = []
+        elif line == "trace end":
+            if current is not None:
+                dumps.append(current)
+            current = None
+        elif current is not None:
+            fields = line.split()
+            if len(fields) == 3 and all(f.isdigit() for f in fields):
+                current.append(tuple(int(f) for f in fields))
+    return dumps
+
+
+def convert(entries):
+    """chrome trace events for one dump, time starts at the first entry"""
+    events = [{"ph": "M", "name": "thread_name", "pid": 0, "tid": tid,
+               "args": {"name": name}} for tid, name in enumerate(TRACKS)]
+    open_slices = {}
+    ticks = 0
+    prev = None
+    for stamp, event_id, arg in entries:
+        if prev is not None:
+            ticks += (stamp - prev) % STAMP_WRAP
+        prev = stamp
+
+        name, phase, track = EVENTS.get(event_id, ("event %d" % event_id, "i", "loop"))
+        if event_id in (5, 6):
+            name = I2C_CLIENTS.get(arg, name)
+        elif event_id == 13:
+            name = "ui " + UI_EVENTS.get(arg, str(arg))
+
+        # the ring may start in the middle of a slice
+        key = (track, name)
+        if phase == "E":
+            if not open_slices.get(key):
+                continue
+            open_slices[key] -= 1
+        elif phase == "B":
+            open_slices[key] = open_slices.get(key, 0) + 1
+
+        event = {"name": name, "ph": phase, "ts": ticks * US_PER_TICK,
+                 "pid": 0, "tid": TRACKS.index(track), "args": {"arg": arg}}
+        if phase == "i":
+            event["s"] = "t"
+        events.append(event)
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    parser.add_argument("log", help="serial log, - for stdin")
+    parser.add_argument("-o", "--output", help="json file, stdout if omitted")
+    parser.add_argument("--dump", type=int, default=-1,
+                        help="which dump of the log to convert, the last by default")
+    args = parser.parse_args()
+
+    source = sys.stdin if args.log == "-" else open(args.log, errors="replace")
+    with source:
+        dumps = read_dumps(source)
+    if not dumps:
+        sys.exit("no trace dump found in " + args.log)
+
+    trace = {"traceEvents": convert(dumps[args.dump]), "displayTimeUnit": "ms"}
+    if args.output:
+        with open(args.output, "w") as out:
+            json.dump(trace, out)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
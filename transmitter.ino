@@ -9,19 +9,33 @@
 * A0    - J1_X                          D11   - MOSI
 * A1    - J1_Y                          D10   - CE
 * A2    - J2_Y                          D9    - CNS
-* A3    - J2_Y                          D8    -
+* A3    - J2_Y                          D8    - IRQ
 * A4    - SDA      (LCD and MPU-6050)   D7    -
 * A5    - SCL      (LCD and MPU-6050)   D6    - J2_SW
 * A6                                    D5    - J1_SW
 * A7                                    D4    - ROT ENC SW
 *                                       D3    - ROT ENC DT
 *                                       D2    - ROT ENC CLK
+*
+* the pins are described once, in Board.h
 */
 
 #include "Globals.h"
 #include "Configurations.h"
 #include "ProcessDataOut.h"
 #include "RotaryEncoder.h"
+#include "Fleet.h"
+#include "Power.h"
+#include "Latency.h"
+#include "Stats.h"
+#include "Deadline.h"
+#include "I2cArbiter.h"
+#include "Telemetry.h"
+#include "RadioTx.h"
+#include "Tuning.h"
+#include "Control.h"
+#include "RetryPolicy.h"
+#include "Boot.h"
 #include <SPI.h>
 #include <LiquidCrystal_I2C.h>
 #include <RF24.h>
@@ -31,63 +45,40 @@
 using Globals::transmitter;
 using Globals::transmitter_address;
 using Globals::data_pkg;
-// joystick
-using Globals::j1_vrx_pin;
-using Globals::j1_vry_pin;
-using Globals::j1_sw_pin;
-
-using Globals::j2_vrx_pin;
-using Globals::j2_vry_pin;
-using Globals::j2_sw_pin;
-
 // lcd
 using Globals::lcd;
 
-// mpu-6050
-using Globals::mpu_addr;
-using Globals::pwr_mgmt_1;
-using Globals::start_data_addr;
-
-/*TEST remove*/
-//struct DataIn {
-//    int8_t temp;
-//    uint8_t bat;
-//    uint8_t hum;
-//    uint8_t water;
-//    uint8_t light;
-//    uint8_t dist;
-//    uint8_t acc;       
-//};
-int8_t data_in[32];
 void setup() {
-    Serial.begin(9600);
-    Serial.println("Initialization started...");
-    Serial.print("data_pkg: ");Serial.println(sizeof(data_pkg));
-    config_radio(transmitter, transmitter_address);
-    config_joystick(data_pkg.j1,
-                    j1_vrx_pin, INPUT, 
-                    j1_vry_pin, INPUT,
-                    j1_sw_pin, INPUT_PULLUP);
-    config_joystick(data_pkg.j2,
-                    j2_vrx_pin, INPUT, 
-                    j2_vry_pin, INPUT,
-                    j2_sw_pin, INPUT_PULLUP);
-    config_mpu_6050(mpu_addr, pwr_mgmt_1, start_data_addr);
-    config_display(lcd);
+    // at 9600 baud every config line blocked for ~30ms once the
+    // serial buffer filled up
+    Serial.begin(115200);
+    Serial.println(F("Initialization started..."));
+    Serial.print(F("profile: "));Serial.print(InputProfile::active);
+    Serial.print(F(" frame: "));Serial.println(frame_len(InputProfile::active));
+
+    // control path only, frames go out from the first loop
+    Fleet::load(transmitter_address);
+    config_radio(transmitter, Fleet::address(Fleet::active()));
+    RadioTx::config_tx(transmitter);
+    Tuning::config_tuning(transmitter);
+    RetryPolicy::config_retries(transmitter);
+    if (InputProfile::has(InputProfile::J1)) {
+        config_joystick<Board::J1X, Board::J1Y, Board::J1Sw>(data_pkg.j1);
+    }
+    if (InputProfile::has(InputProfile::J2)) {
+        config_joystick<Board::J2X, Board::J2Y, Board::J2Sw>(data_pkg.j2);
+    }
+    Control::config_control(data_pkg);
     config_rot_encoder();
+    Power::config_power();
+
+    // the mpu-6050 and the lcd join from the loop
+    Boot::config_boot();
+    Deadline::config_deadline(transmitter);
     
-    Serial.println("Initialization complete!\n\n");
-    /*TEST remove*/
-    /*temp*/data_in[0] = 37;
-    /*bat*/data_in[1] = 52;
-    /*hum*/data_in[2] = 72;
-    /*water*/data_in[3] = 21;
-    /*light*/data_in[4] = 90;
-    /*dist*/data_in[5] = 60;
-    /*acc*/data_in[6] = 15;
+    Serial.println(F("Initialization complete!\n\n"));
 }
 
-char text[] = "Hello World!";
 bool init_boot = true; // move to globals or remove
 
 void loop() {
@@ -114,13 +105,43 @@ void loop() {
 //    Serial.println(data_pkg.mpu.temp());
 //	delay(2000);
     
-    process_joystick_alt(data_pkg.j1);
-    process_joystick(data_pkg.j2);
-    process_mpu_6050(data_pkg.mpu);
-    process_display(lcd, data_pkg.menu_select, data_pkg.mpu.temp(), data_in); 
+    Deadline::begin();
+
+    // acks of the frame queued last time, if the irq reported them
+    RadioTx::service(transmitter);
+    Power::settle(transmitter);
+
+    // the mpu-6050 shares the i2c bus with the lcd, it is read here
+    // and the control isr picks the sample up on its next tick
+    I2cArbiter::run_imu();
+    Boot::run(lcd);
+
+    Telemetry::update(Fleet::telemetry(Fleet::active()), Fleet::active());
+    if (Boot::ready(Boot::Stage::LCD)) {
+        process_display(lcd, data_pkg.menu_select, data_pkg.mpu.temp(), Fleet::telemetry(Fleet::active()));
+    }
     
-    send_data(transmitter, data_pkg);
-    Serial.print("j2-up: "); Serial.println(data_pkg.j2.up);//delay(2000);
+    // newest inputs first, idle detection looks at them
+    bool fresh = Control::update(data_pkg);
+    Power::update(lcd, data_pkg);
+    
+    // pairing probes switch the writing pipe and the pa level only
+    // changes in between frames, the fifo must be empty
+    if (RadioTx::idle()) {
+        Fleet::service(transmitter);
+        Tuning::service(transmitter);
+    }
+    // one frame per control tick, with the inputs the control isr
+    // sampled last, however long the ui took
+    if (fresh && Power::send_due(transmitter) && send_data(transmitter, data_pkg)) {
+        Power::sent(transmitter);
+    }
+    Stats::poll_serial();
     //process_rot_encoder_isr();
     //process_display(lcd, data_pkg.menu_select, data_pkg.mpu.temp(), init_boot);
+    
+    Deadline::end();
+
+    // sleeps until the next tick when nothing is going on
+    Power::sleep();
 }